@@ -0,0 +1,164 @@
+#include <coffee/coffee.hpp>
+#include <coffee/graphics/device.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Hammers AssetManager with concurrent loads of same assets and verifies that each asset was decoded only once
+// Usage: coffee_asset_stress <filesystem> <asset>... [--threads N] [--rounds N]
+// Only images and meshes are requested, textures of meshes are loaded by meshes themselves
+
+namespace {
+
+    struct Options {
+        std::string filesystemPath {};
+        std::vector<std::string> assets {};
+        uint32_t threads = std::max(std::thread::hardware_concurrency(), 2U);
+        uint32_t rounds = 8U;
+    };
+
+    void loadAsset(coffee::AssetManager& manager, const coffee::FilesystemPtr& filesystem, const coffee::AssetId& id)
+    {
+        switch (filesystem->getMetadata(id).type) {
+            case coffee::Filesystem::FileType::RawImage:
+            case coffee::Filesystem::FileType::BasisImage: {
+                coffee::ImageLoadingInfo loadingInfo {};
+                loadingInfo.filesystem = filesystem;
+                loadingInfo.path = id;
+                manager.loadImage(loadingInfo);
+                break;
+            }
+            case coffee::Filesystem::FileType::Mesh: {
+                coffee::MeshLoadingInfo loadingInfo {};
+                loadingInfo.filesystem = filesystem;
+                loadingInfo.path = id;
+                manager.loadMesh(loadingInfo);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // Amount of decodes is amount of cache misses, because loader callback is executed exactly once per miss
+    std::vector<uint64_t> decodeCounts(const coffee::AssetStatistics& statistics)
+    {
+        std::vector<uint64_t> result {};
+
+        for (const auto& type : statistics.types) {
+            result.push_back(type.misses);
+        }
+
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options options {};
+
+    for (int index = 1; index < argc; index++) {
+        std::string argument = argv[index];
+
+        if (argument == "--threads" && index + 1 < argc) {
+            options.threads = static_cast<uint32_t>(std::max(std::atoi(argv[++index]), 1));
+        }
+        else if (argument == "--rounds" && index + 1 < argc) {
+            options.rounds = static_cast<uint32_t>(std::max(std::atoi(argv[++index]), 1));
+        }
+        else if (options.filesystemPath.empty()) {
+            options.filesystemPath = std::move(argument);
+        }
+        else {
+            options.assets.push_back(std::move(argument));
+        }
+    }
+
+    if (options.filesystemPath.empty() || options.assets.empty()) {
+        fmt::print("Usage: {} <filesystem> <asset>... [--threads N] [--rounds N]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    coffee::graphics::DevicePtr device = coffee::graphics::Device::create();
+    coffee::FilesystemPtr filesystem = coffee::Filesystem::create(options.filesystemPath);
+
+    std::vector<coffee::AssetId> ids {};
+
+    for (const auto& asset : options.assets) {
+        ids.push_back(coffee::AssetId::intern(asset));
+    }
+
+    // Sequential load on fresh manager gives amount of decodes that is expected, including textures of meshes
+    std::vector<uint64_t> expectedDecodes {};
+
+    {
+        coffee::AssetManagerPtr manager = coffee::AssetManager::create(device);
+
+        for (const auto& id : ids) {
+            loadAsset(*manager, filesystem, id);
+        }
+
+        expectedDecodes = decodeCounts(manager->statistics());
+    }
+
+    uint32_t failedRounds = 0U;
+
+    for (uint32_t round = 0; round < options.rounds; round++) {
+        coffee::AssetManagerPtr manager = coffee::AssetManager::create(device);
+        std::atomic<bool> start { false };
+        std::vector<std::thread> threads {};
+
+        for (uint32_t thread = 0; thread < options.threads; thread++) {
+            threads.emplace_back([&, thread]() {
+                // Every thread requests same assets in different order, so all of them are racing for same ids
+                std::vector<coffee::AssetId> order = ids;
+                std::shuffle(order.begin(), order.end(), std::mt19937 { round * options.threads + thread });
+
+                while (!start.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+
+                for (const auto& id : order) {
+                    loadAsset(*manager, filesystem, id);
+                }
+            });
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        start.store(true, std::memory_order_release);
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        coffee::AssetStatistics statistics = manager->statistics();
+        bool matches = decodeCounts(statistics) == expectedDecodes && statistics.failedLoads == 0;
+
+        fmt::print(
+            "Round {}: {} threads, {:.2f} ms, {} failed loads, decodes {}\n",
+            round,
+            options.threads,
+            elapsed,
+            statistics.failedLoads,
+            matches ? "match" : "MISMATCH"
+        );
+
+        if (!matches) {
+            failedRounds++;
+        }
+    }
+
+    device->waitDeviceIdle();
+
+    return failedRounds == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -1,25 +1,52 @@
 #ifndef COFFEE_AUDIO_BUFFER
 #define COFFEE_AUDIO_BUFFER
 
+#include <coffee/audio/enums.hpp>
 #include <coffee/utils/non_copyable.hpp>
 
 #include <AL/al.h>
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 namespace coffee { namespace audio {
 
+    class Buffer;
+    using BufferPtr = std::shared_ptr<Buffer>;
+
     class Buffer : NonCopyable {
     public:
         ~Buffer() noexcept;
 
+        Buffer(Buffer&& other) noexcept;
+        Buffer& operator=(Buffer&& other) noexcept;
+
         static Buffer create();
         static std::vector<Buffer> create(uint32_t size);
 
-        void upload();
+        // Copies PCM samples into OpenAL storage, provided memory can be freed right after this call
+        void upload(AudioFormat format, const void* data, size_t size, uint32_t frequency);
+
+        inline ALuint handle() const noexcept { return bufferHandle_; }
+
+        inline AudioFormat format() const noexcept { return format_; }
+
+        inline uint32_t frequency() const noexcept { return frequency_; }
+
+        // Amount of bytes that was uploaded
+        inline size_t size() const noexcept { return size_; }
 
     private:
+        Buffer();
+        Buffer(ALuint handle) noexcept;
+
+        static void validate();
+
+        ALuint bufferHandle_ = AL_INVALID;
+        AudioFormat format_ = AudioFormat::None;
+        uint32_t frequency_ = 0;
+        size_t size_ = 0;
     };
 
 }} // namespace coffee::audio
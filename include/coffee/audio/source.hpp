@@ -18,6 +18,9 @@ namespace coffee { namespace audio {
 
         static Source create();
 
+        // Source doesn't own buffer, so it must be kept alive while source is using it
+        void setBuffer(const Buffer& buffer);
+
         void play();
         void pause();
         void stop();
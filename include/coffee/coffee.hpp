@@ -12,11 +12,18 @@
 #include <coffee/graphics/monitor.hpp>
 #include <coffee/graphics/render_pass.hpp>
 #include <coffee/graphics/sampler.hpp>
+#include <coffee/graphics/staging_ring.hpp>
 #include <coffee/graphics/window.hpp>
 
+#include <coffee/interfaces/asset_handle.hpp>
+#include <coffee/interfaces/asset_id.hpp>
 #include <coffee/interfaces/asset_manager.hpp>
+#include <coffee/interfaces/byte_buffer.hpp>
+#include <coffee/interfaces/expected.hpp>
 #include <coffee/interfaces/filesystem.hpp>
 #include <coffee/interfaces/loop_handler.hpp>
+#include <coffee/interfaces/mesh_format.hpp>
+#include <coffee/interfaces/mesh_optimizer.hpp>
 
 #include <coffee/utils/log.hpp>
 
@@ -29,6 +29,10 @@ namespace coffee { namespace graphics {
 
         AABBPoints transform(const glm::mat4& meshMatrix) const noexcept;
 
+        // Largest extent of box on screen after projection, as fraction of screen size
+        // Boxes that are crossing camera plane are treated as covering whole screen
+        float projectedSize(const glm::mat4& modelViewProjection) const noexcept;
+
         glm::vec4 min {};
         glm::vec4 max {};
     };
@@ -71,6 +71,15 @@ namespace coffee { namespace graphics {
             return info.pMappedData;
         }
 
+        // Returns amount of memory that was actually allocated, might be bigger than requested because of alignment
+        inline VkDeviceSize allocationSize() const noexcept
+        {
+            VmaAllocationInfo info {};
+            vmaGetAllocationInfo(device_->allocator(), allocation_, &info);
+
+            return info.size;
+        }
+
         inline bool isHostVisible() const noexcept { return isHostVisible_; }
 
         inline bool isHostCoherent() const noexcept { return isHostCoherent_; }
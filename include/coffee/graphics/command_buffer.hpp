@@ -173,7 +173,7 @@ namespace coffee {
             {
                 COFFEE_ASSERT(srcImage != nullptr, "Invalid srcImage provided.");
                 COFFEE_ASSERT(dstImage != nullptr, "Invalid dstImage provided.");
-                COFFEE_ASSERT(srcImage != dstImage, "srcImage must be other than dstImage.");
+                // Blitting inside of same image is allowed as long as regions are referencing different subresources, e.g. mipmap generation
 
                 COFFEE_ASSERT(regionCount > 0, "regionCount must be greater than 0.");
                 COFFEE_ASSERT(regionCount <= kUIntMax, "regionCount must be less than {}.", kUIntMax);
@@ -449,7 +449,24 @@ namespace coffee {
                 vkCmdBindVertexBuffers(buffer_, 0U, 1U, buffers, offsets);
 
                 if (mesh->indicesBuffer != nullptr) {
-                    vkCmdBindIndexBuffer(buffer_, mesh->indicesBuffer->buffer(), 0U, VK_INDEX_TYPE_UINT32);
+                    vkCmdBindIndexBuffer(buffer_, mesh->indicesBuffer->buffer(), 0U, mesh->indexType);
+                }
+            }
+
+            // Binds position only stream instead of full vertices, submeshes and meshlets are drawn same way after that
+            inline void bindMeshPositions(const MeshPtr& mesh) const noexcept
+            {
+                COFFEE_ASSERT(type == CommandBufferType::Graphics, "You can only bind meshes on graphics command buffers.");
+
+                COFFEE_ASSERT(mesh != nullptr, "Invalid mesh provided.");
+                COFFEE_ASSERT(mesh->positionsBuffer != nullptr, "Mesh was loaded without position only stream.");
+
+                VkBuffer buffers[] = { mesh->positionsBuffer->buffer() };
+                VkDeviceSize offsets[] = { 0ULL };
+                vkCmdBindVertexBuffers(buffer_, 0U, 1U, buffers, offsets);
+
+                if (mesh->indicesBuffer != nullptr) {
+                    vkCmdBindIndexBuffer(buffer_, mesh->indicesBuffer->buffer(), 0U, mesh->indexType);
                 }
             }
 
@@ -467,13 +484,14 @@ namespace coffee {
                 vkCmdBindVertexBuffers(buffer_, static_cast<uint32_t>(firstBinding), static_cast<uint32_t>(bindingCount), pBuffers, pOffsets);
             }
 
-            inline void bindIndexBuffer(const BufferPtr& indexBuffer, VkDeviceSize offset = 0ULL) const noexcept
+            inline void bindIndexBuffer(const BufferPtr& indexBuffer, VkDeviceSize offset = 0ULL, VkIndexType indexType = VK_INDEX_TYPE_UINT32)
+                const noexcept
             {
                 COFFEE_ASSERT(type == CommandBufferType::Graphics, "You can only bind index buffer on graphics command buffers.");
 
                 COFFEE_ASSERT(indexBuffer != nullptr, "Invalid indexBuffer provided.");
 
-                vkCmdBindIndexBuffer(buffer_, indexBuffer->buffer(), offset, VK_INDEX_TYPE_UINT32);
+                vkCmdBindIndexBuffer(buffer_, indexBuffer->buffer(), offset, indexType);
             }
 
             inline void draw(uint32_t vertexCount, uint32_t instanceCount = 1U, uint32_t firstVertex = 0U, uint32_t firstInstance = 0U) const noexcept
@@ -483,8 +501,8 @@ namespace coffee {
                 vkCmdDraw(buffer_, vertexCount, instanceCount, firstVertex, firstInstance);
             }
 
-            // NOTE: You must call bindMesh() before using submesh drawing
-            inline void drawSubMesh(const SubMesh& submesh) const noexcept
+            // NOTE: You must call bindMesh() before using submesh drawing, LOD is expected to be result of SubMesh::selectLod()
+            inline void drawSubMesh(const SubMesh& submesh, uint32_t lod = 0U) const noexcept
             {
                 COFFEE_ASSERT(type == CommandBufferType::Graphics, "You can only draw on graphics command buffers.");
 
@@ -493,9 +511,23 @@ namespace coffee {
                     return;
                 }
 
+                if (lod > 0 && lod <= submesh.lods.size()) {
+                    const SubMeshLod& level = submesh.lods[lod - 1];
+                    vkCmdDrawIndexed(buffer_, level.indicesCount, 1U, level.indicesOffset, submesh.verticesOffset, 0U);
+                    return;
+                }
+
                 vkCmdDrawIndexed(buffer_, submesh.indicesCount, 1U, submesh.indicesOffset, submesh.verticesOffset, 0U);
             }
 
+            // NOTE: You must call bindMesh() before using meshlet drawing, provided submesh must be owner of meshlet
+            inline void drawMeshlet(const SubMesh& submesh, const Meshlet& meshlet) const noexcept
+            {
+                COFFEE_ASSERT(type == CommandBufferType::Graphics, "You can only draw on graphics command buffers.");
+
+                vkCmdDrawIndexed(buffer_, meshlet.indicesCount, 1U, meshlet.indicesOffset, submesh.verticesOffset, 0U);
+            }
+
             // NOTE: You must call bindMesh() before using mesh drawing
             inline void drawMesh(const MeshPtr& mesh) const noexcept
             {
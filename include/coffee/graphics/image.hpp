@@ -5,6 +5,8 @@
 #include <coffee/graphics/sampler.hpp>
 #include <coffee/utils/non_moveable.hpp>
 
+#include <atomic>
+
 namespace coffee { namespace graphics {
 
     struct ImageConfiguration {
@@ -42,6 +44,26 @@ namespace coffee { namespace graphics {
 
         inline const VkImage& image() const noexcept { return image_; }
 
+        // Returns amount of device memory that was allocated for this image, swapchain images always returns 0
+        inline VkDeviceSize allocationSize() const noexcept
+        {
+            if (allocation_ == VK_NULL_HANDLE) {
+                return 0ULL;
+            }
+
+            VmaAllocationInfo info {};
+            vmaGetAllocationInfo(device_->allocator(), allocation_, &info);
+
+            return info.size;
+        }
+
+        // Most detailed mip level that contains valid data, levels above it are still streaming and must not be sampled
+        // Must be applied as minimal LOD, either through SamplerConfiguration::minLod or inside of shader
+        inline uint32_t residentMipLevel() const noexcept { return residentMipLevel_.load(std::memory_order_acquire); }
+
+        // Must be called only after commands that uploads this level were submitted
+        inline void setResidentMipLevel(uint32_t mipLevel) noexcept { residentMipLevel_.store(mipLevel, std::memory_order_release); }
+
         const bool swapChainImage = false;
         const VkImageType imageType = VK_IMAGE_TYPE_2D;
         const VkFormat imageFormat = VK_FORMAT_UNDEFINED;
@@ -61,6 +83,8 @@ namespace coffee { namespace graphics {
         VmaAllocation allocation_ = VK_NULL_HANDLE;
         VkImage image_ = VK_NULL_HANDLE;
 
+        std::atomic<uint32_t> residentMipLevel_ { 0U };
+
         friend class ImageView;
         friend class SwapChain;
     };
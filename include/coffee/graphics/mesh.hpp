@@ -1,18 +1,36 @@
 #ifndef COFFEE_GRAPHICS_MESH
 #define COFFEE_GRAPHICS_MESH
 
+#include <coffee/graphics/meshlet.hpp>
 #include <coffee/graphics/submesh.hpp>
+#include <coffee/graphics/vertex.hpp>
 
 namespace coffee { namespace graphics {
 
     class Mesh : NonMoveable {
     public:
-        Mesh(std::vector<SubMesh>&& subMeshes, BufferPtr&& verticesBuffer, BufferPtr&& indicesBuffer);
+        Mesh(
+            std::vector<SubMesh>&& subMeshes,
+            BufferPtr&& verticesBuffer,
+            BufferPtr&& indicesBuffer,
+            VkIndexType indexType = VK_INDEX_TYPE_UINT32,
+            std::vector<Meshlet>&& meshlets = {},
+            VertexFormat vertexFormat = VertexFormat::Full,
+            BufferPtr&& positionsBuffer = nullptr
+        );
         ~Mesh() noexcept = default;
 
         const std::vector<SubMesh> subMeshes;
         const BufferPtr verticesBuffer;
         const BufferPtr indicesBuffer;
+        // Either VK_INDEX_TYPE_UINT16 or VK_INDEX_TYPE_UINT32, offsets and counts of submeshes are always in indices
+        const VkIndexType indexType;
+        // Empty if mesh file doesn't contain meshlets and they weren't requested at load time
+        const std::vector<Meshlet> meshlets;
+        // Layout of vertices buffer, pipelines must be created with matching makeInputBinding()
+        const VertexFormat vertexFormat;
+        // Position only stream for depth and shadow passes, nullptr unless it was requested at load time
+        const BufferPtr positionsBuffer;
     };
 
     using MeshPtr = std::shared_ptr<Mesh>;
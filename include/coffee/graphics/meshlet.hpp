@@ -0,0 +1,50 @@
+#ifndef COFFEE_GRAPHICS_MESHLET
+#define COFFEE_GRAPHICS_MESHLET
+
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+
+namespace coffee { namespace graphics {
+
+    // Small cluster of triangles that is stored as contiguous range inside index buffer of mesh
+    // Layout is fixed and consists only of 4-byte fields, so meshlets can be uploaded as is into storage buffer for compute culling
+    struct Meshlet {
+        // Bounding sphere in mesh space
+        glm::vec3 center {};
+        float radius = 0.0f;
+        // Normal cone, every triangle of meshlet faces away from camera if isBackfacing() returns true
+        glm::vec3 coneAxis {};
+        // Sine of cone spread angle, 1.0f disables cone culling for meshlets with spread wider than 90 degrees
+        float coneCutoff = 1.0f;
+        // Absolute offset inside index buffer of mesh, vertex offset is same as in parent submesh
+        uint32_t indicesOffset = 0U;
+        uint32_t indicesCount = 0U;
+
+        // Both functions expect camera position in mesh space
+        inline bool isBackfacing(const glm::vec3& cameraPosition) const noexcept
+        {
+            glm::vec3 direction = center - cameraPosition;
+            return glm::dot(direction, coneAxis) >= coneCutoff * glm::length(direction) + radius;
+        }
+
+        // Planes are expected in form of dot(plane.xyz, point) + plane.w >= 0 for points inside
+        inline bool isOutside(const glm::vec4* planes, uint32_t amountOfPlanes) const noexcept
+        {
+            for (uint32_t index = 0; index < amountOfPlanes; index++) {
+                if (glm::dot(glm::vec3 { planes[index] }, center) + planes[index].w < -radius) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    };
+
+    static_assert(sizeof(Meshlet) == 40, "Meshlet must not contain padding.");
+
+}} // namespace coffee::graphics
+
+#endif
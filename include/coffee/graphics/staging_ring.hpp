@@ -0,0 +1,124 @@
+#ifndef COFFEE_GRAPHICS_STAGING_RING
+#define COFFEE_GRAPHICS_STAGING_RING
+
+#include <coffee/graphics/buffer.hpp>
+#include <coffee/graphics/fence.hpp>
+#include <coffee/utils/latency_histogram.hpp>
+#include <coffee/utils/non_copyable.hpp>
+
+#include <oneapi/tbb/queuing_mutex.h>
+
+#include <deque>
+
+namespace coffee { namespace graphics {
+
+    struct StagingRingConfiguration {
+        // Size of persistently mapped ring in bytes
+        size_t size = 64ULL * 1024ULL * 1024ULL;
+        // Requests that are bigger than this value will be placed into dedicated buffer instead of ring
+        // Zero means half of ring size
+        size_t dedicatedThreshold = 0ULL;
+    };
+
+    class StagingRing;
+    using StagingRingPtr = std::shared_ptr<StagingRing>;
+
+    // Region of staging memory that was given out by StagingRing
+    // Region must be submitted through submit() exactly once, otherwise it will be given back without any synchronization
+    class StagingRegion : NonCopyable {
+    public:
+        StagingRegion(StagingRegion&& other) noexcept;
+        StagingRegion& operator=(StagingRegion&&) = delete;
+        ~StagingRegion() noexcept;
+
+        // Flushes written region, required for non-coherent memory
+        void flush();
+        // Keeps object alive until GPU is done with this region, e.g. destination images and semaphores
+        void keepAlive(std::shared_ptr<void> object);
+        // Submits command buffer with internal fence, which will be used to reclaim this region later
+        // Must be the last submit that depends on this region
+        void submit(CommandBuffer&& commandBuffer, const SubmitSemaphores& semaphores = {});
+
+        // Buffer that must be used as source of copy commands, might be either ring itself or dedicated buffer
+        const BufferPtr buffer;
+        // Offset in bytes from beginning of buffer
+        const VkDeviceSize offset;
+        // Size in bytes that was requested
+        const VkDeviceSize size;
+        // Host pointer to beginning of region, offset already applied
+        uint8_t* const memory;
+
+    private:
+        StagingRegion(StagingRing* ring, uint64_t recordIndex, BufferPtr buffer, VkDeviceSize offset, VkDeviceSize size, uint8_t* memory);
+
+        StagingRing* ring_ = nullptr;
+        uint64_t recordIndex_ = 0ULL;
+        FencePtr fence_ = nullptr;
+        std::vector<std::shared_ptr<void>> keepAlive_ {};
+        std::chrono::steady_clock::time_point submitTime_ {};
+        bool submitted_ = false;
+
+        friend class StagingRing;
+    };
+
+    // Persistently mapped host-visible buffer that linearly sub-allocates memory for uploads
+    // Regions are reclaimed in same order as they were given, once fence of their submit is signaled
+    // Requests that doesn't fit into ring are placed into dedicated buffers, so allocation never stalls
+    // Calling any of functions below is thread-safe
+    class StagingRing : NonMoveable {
+    public:
+        ~StagingRing() noexcept;
+
+        static StagingRingPtr create(const DevicePtr& device, const StagingRingConfiguration& configuration = {});
+
+        StagingRegion allocate(size_t size, size_t alignment = 16ULL);
+
+        // Returns back every region which submit was completed on GPU
+        void reclaim();
+
+        inline size_t capacity() const noexcept { return capacity_; }
+
+        // Time between submit and moment when reclaim noticed that GPU is done, so it's resolution is limited by how often reclaim is called
+        inline const LatencyHistogram& completionLatency() const noexcept { return completionLatency_; }
+
+    private:
+        struct Record {
+            uint64_t end = 0ULL;
+            FencePtr fence = nullptr;
+            BufferPtr dedicatedBuffer = nullptr;
+            std::vector<std::shared_ptr<void>> keepAlive {};
+            std::chrono::steady_clock::time_point submitTime {};
+            bool released = false;
+        };
+
+        StagingRing(const DevicePtr& device, const StagingRingConfiguration& configuration);
+
+        StagingRegion allocateDedicated(size_t size);
+        uint64_t pushRecord(uint64_t end, BufferPtr dedicatedBuffer);
+        FencePtr acquireFence();
+        void release(StagingRegion& region) noexcept;
+        void reclaimUnsafe() noexcept;
+
+        DevicePtr device_;
+        BufferPtr buffer_;
+        uint8_t* memory_ = nullptr;
+
+        const size_t capacity_;
+        const size_t dedicatedThreshold_;
+        const size_t minimalAlignment_;
+
+        tbb::queuing_mutex mutex_ {};
+        uint64_t head_ = 0ULL;
+        uint64_t tail_ = 0ULL;
+        uint64_t firstRecordIndex_ = 0ULL;
+        std::deque<Record> records_ {};
+        std::vector<FencePtr> freeFences_ {};
+
+        LatencyHistogram completionLatency_ {};
+
+        friend class StagingRegion;
+    };
+
+}} // namespace coffee::graphics
+
+#endif
@@ -4,23 +4,46 @@
 #include <coffee/graphics/aabb.hpp>
 #include <coffee/graphics/buffer.hpp>
 #include <coffee/graphics/materials.hpp>
+#include <coffee/graphics/submesh_lod.hpp>
+
+#include <vector>
 
 namespace coffee { namespace graphics {
 
     class SubMesh : NonCopyable {
     public:
-        SubMesh(Materials&& mats, AABB&& aabb, uint32_t vertsOffset, uint32_t indsOffset, uint32_t vertsCount, uint32_t indsCount);
+        SubMesh(
+            Materials&& mats,
+            AABB&& aabb,
+            uint32_t vertsOffset,
+            uint32_t indsOffset,
+            uint32_t vertsCount,
+            uint32_t indsCount,
+            uint32_t meshletsOffset = 0U,
+            uint32_t meshletsCount = 0U,
+            std::vector<SubMeshLod>&& lods = {}
+        );
         ~SubMesh() noexcept = default;
 
         SubMesh(SubMesh&& other) noexcept = default;
         SubMesh& operator=(SubMesh&& other) noexcept = delete;
 
-        Materials materials;
+        // Materials are internally synchronized, so they can be updated even after mesh was created
+        mutable Materials materials;
         const AABB aabb;
         const uint32_t verticesOffset;
         const uint32_t indicesOffset;
         const uint32_t verticesCount;
         const uint32_t indicesCount;
+        // Range inside Mesh::meshlets, meshlets together are covering exactly same indices as submesh itself
+        const uint32_t meshletsOffset;
+        const uint32_t meshletsCount;
+        // Ordered from most detailed to least detailed, submesh itself is LOD 0 and isn't stored here
+        const std::vector<SubMeshLod> lods;
+
+        // Returns coarsest LOD which deviation from original surface stays under provided amount of pixels
+        // Projected size is expected to be result of AABB::projectedSize() and screen height to be in pixels
+        uint32_t selectLod(float projectedSize, float screenHeight, float maxPixelError = 1.0f) const noexcept;
 
         friend class Mesh;
     };
@@ -0,0 +1,19 @@
+#ifndef COFFEE_GRAPHICS_SUBMESH_LOD
+#define COFFEE_GRAPHICS_SUBMESH_LOD
+
+#include <cstdint>
+
+namespace coffee { namespace graphics {
+
+    // Simplified version of submesh, it uses same vertices and it's indices are stored after indices of every submesh
+    struct SubMeshLod {
+        // Absolute offset inside index buffer of mesh, vertex offset is same as in parent submesh
+        uint32_t indicesOffset = 0U;
+        uint32_t indicesCount = 0U;
+        // Approximate deviation from original surface, relative to largest extent of submesh AABB
+        float error = 0.0f;
+    };
+
+}} // namespace coffee::graphics
+
+#endif
@@ -6,10 +6,19 @@
 #include <glm/glm.hpp>
 #include <volk/volk.h>
 
-#include <vector>
+#include <array>
+#include <cstddef>
 
 namespace coffee { namespace graphics {
 
+    // Layout of vertex buffer of mesh, files are always storing Vertex and conversion is done when mesh is loaded
+    enum class VertexFormat : uint32_t {
+        // Vertex, 32 bytes
+        Full = 0,
+        // CompactVertex, 20 bytes
+        Compact = 1
+    };
+
     class Vertex {
     public:
         glm::vec3 position {};
@@ -17,22 +26,96 @@ namespace coffee { namespace graphics {
         glm::uint32 texCoords {};
         glm::u16vec3 tangent {};
 
-        static inline std::vector<graphics::InputElement> getElementDescriptions()
-        {
-            std::vector<graphics::InputElement> elements {};
+        bool operator==(const Vertex& other);
+        bool operator!=(const Vertex& other);
+    };
+
+    // Position is quantized relative to AABB of submesh, so it must be restored in shader as min + position.xyz * (max - min)
+    // Position.w is always 1.0, normal and tangent are unit vectors in octahedral encoding
+    struct CompactVertex {
+        glm::u16vec4 position {};
+        glm::i16vec2 normal {};
+        glm::i16vec2 tangent {};
+        glm::uint32 texCoords {};
+
+        // Bounds must be same as AABB of submesh that owns this vertex
+        static CompactVertex encode(const Vertex& vertex, const glm::vec3& aabbMin, const glm::vec3& aabbMax) noexcept;
+    };
 
-            elements.push_back({ 0U, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position) });
-            elements.push_back({ 1U, VK_FORMAT_R16G16B16_SNORM, offsetof(Vertex, normal) });
-            elements.push_back({ 2U, VK_FORMAT_R16G16_SFLOAT, offsetof(Vertex, texCoords) });
-            elements.push_back({ 3U, VK_FORMAT_R16G16B16_SNORM, offsetof(Vertex, tangent) });
+    // Position only streams for depth and shadow passes, their positions are bitwise same as in respective full vertex
+    // This way depth prepass and main pass are producing same depth values as long as position is computed same way in shaders
+    struct PositionVertex {
+        glm::vec3 position {};
 
-            return elements;
-        }
+        static PositionVertex encode(const Vertex& vertex, const glm::vec3& aabbMin, const glm::vec3& aabbMax) noexcept;
+    };
 
-        bool operator==(const Vertex& other);
-        bool operator!=(const Vertex& other);
+    struct CompactPositionVertex {
+        glm::u16vec4 position {};
+
+        static CompactPositionVertex encode(const Vertex& vertex, const glm::vec3& aabbMin, const glm::vec3& aabbMax) noexcept;
     };
 
+    // Input elements of every vertex type, locations are same across types, so shaders differ only in decoding of attributes
+    template <typename T>
+    struct VertexLayout;
+
+    template <>
+    struct VertexLayout<Vertex> {
+        static constexpr std::array<InputElement, 4> elements = { {
+            { 0U, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position) },
+            { 1U, VK_FORMAT_R16G16B16_SNORM, offsetof(Vertex, normal) },
+            { 2U, VK_FORMAT_R16G16_SFLOAT, offsetof(Vertex, texCoords) },
+            { 3U, VK_FORMAT_R16G16B16_SNORM, offsetof(Vertex, tangent) },
+        } };
+    };
+
+    template <>
+    struct VertexLayout<CompactVertex> {
+        static constexpr std::array<InputElement, 4> elements = { {
+            { 0U, VK_FORMAT_R16G16B16A16_UNORM, offsetof(CompactVertex, position) },
+            { 1U, VK_FORMAT_R16G16_SNORM, offsetof(CompactVertex, normal) },
+            { 2U, VK_FORMAT_R16G16_SFLOAT, offsetof(CompactVertex, texCoords) },
+            { 3U, VK_FORMAT_R16G16_SNORM, offsetof(CompactVertex, tangent) },
+        } };
+    };
+
+    template <>
+    struct VertexLayout<PositionVertex> {
+        static constexpr std::array<InputElement, 1> elements = { {
+            { 0U, VK_FORMAT_R32G32B32_SFLOAT, offsetof(PositionVertex, position) },
+        } };
+    };
+
+    template <>
+    struct VertexLayout<CompactPositionVertex> {
+        static constexpr std::array<InputElement, 1> elements = { {
+            { 0U, VK_FORMAT_R16G16B16A16_UNORM, offsetof(CompactPositionVertex, position) },
+        } };
+    };
+
+    static_assert(sizeof(CompactVertex) == 20, "CompactVertex must not contain padding.");
+    static_assert(sizeof(PositionVertex) == 12, "PositionVertex must not contain padding.");
+    static_assert(sizeof(CompactPositionVertex) == 8, "CompactPositionVertex must not contain padding.");
+
+    // Stride and elements are known at compile time, so binding for any vertex type is done with single call
+    template <typename T>
+    inline InputBinding makeInputBinding(uint32_t binding = 0U, VkVertexInputRate inputRate = VK_VERTEX_INPUT_RATE_VERTEX)
+    {
+        const auto& elements = VertexLayout<T>::elements;
+        return { binding, static_cast<uint32_t>(sizeof(T)), inputRate, { elements.begin(), elements.end() } };
+    }
+
+    constexpr uint32_t vertexStride(VertexFormat format) noexcept
+    {
+        return format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(Vertex);
+    }
+
+    constexpr uint32_t positionStride(VertexFormat format) noexcept
+    {
+        return format == VertexFormat::Compact ? sizeof(CompactPositionVertex) : sizeof(PositionVertex);
+    }
+
 }} // namespace coffee::graphics
 
 namespace std {
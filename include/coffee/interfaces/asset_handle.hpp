@@ -0,0 +1,214 @@
+#ifndef COFFEE_INTERFACES_ASSET_HANDLE
+#define COFFEE_INTERFACES_ASSET_HANDLE
+
+#include <coffee/utils/log.hpp>
+#include <coffee/utils/non_moveable.hpp>
+
+#include <oneapi/tbb/concurrent_vector.h>
+#include <oneapi/tbb/queuing_mutex.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace coffee {
+
+    namespace graphics {
+
+        class Image;
+        class Mesh;
+        class ShaderModule;
+
+    } // namespace graphics
+
+    template <typename T>
+    class HandlePool;
+
+    // Typed 64-bit reference to asset that is owned by AssetManager
+    // Copying handle doesn't touch any reference counters, and handle that outlived it's asset is detected by generation
+    template <typename T>
+    class AssetHandle {
+    public:
+        constexpr AssetHandle() noexcept = default;
+
+        // Zero generation is never given out, so default constructed handle is always invalid
+        constexpr bool isValid() const noexcept { return generation_ != 0; }
+
+        constexpr uint32_t index() const noexcept { return index_; }
+
+        constexpr uint32_t generation() const noexcept { return generation_; }
+
+        // Packed representation, suitable as key or for passing to shaders
+        constexpr uint64_t value() const noexcept { return (static_cast<uint64_t>(generation_) << 32) | index_; }
+
+        constexpr bool operator==(const AssetHandle& other) const noexcept { return index_ == other.index_ && generation_ == other.generation_; }
+
+        constexpr bool operator!=(const AssetHandle& other) const noexcept { return !(*this == other); }
+
+    private:
+        constexpr AssetHandle(uint32_t index, uint32_t generation) noexcept : index_ { index }, generation_ { generation } {}
+
+        uint32_t index_ = 0U;
+        uint32_t generation_ = 0U;
+
+        friend class HandlePool<T>;
+    };
+
+    using TextureHandle = AssetHandle<graphics::Image>;
+    using MeshHandle = AssetHandle<graphics::Mesh>;
+    using ShaderHandle = AssetHandle<graphics::ShaderModule>;
+
+    // Dense array of slots that hands out generational handles to objects
+    // Slots are never relocated, so resolve() is lock-free and doesn't modify any reference counters
+    // Handles must be passed between threads through any synchronization, same as any other data
+    // Released slots are recycled only after provided amount of frames, so pointers resolved in current frame stays valid
+    template <typename T>
+    class HandlePool : NonMoveable {
+    public:
+        using Handle = AssetHandle<T>;
+
+        HandlePool(uint64_t retireFrames) noexcept : retireFrames_ { retireFrames } {}
+
+        ~HandlePool() noexcept = default;
+
+        // Returns handle of object with same key if it's already in pool, otherwise object is placed into free slot
+        // Every acquire must be followed by release
+        Handle acquire(uint64_t key, std::shared_ptr<T> object)
+        {
+            COFFEE_ASSERT(object != nullptr, "Invalid object provided.");
+
+            tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+            if (auto it = slotsByKey_.find(key); it != slotsByKey_.end()) {
+                Slot& slot = slots_[it->second];
+                slot.references++;
+
+                return Handle { it->second, slot.generation.load(std::memory_order_relaxed) };
+            }
+
+            uint32_t index = 0U;
+
+            if (!freeSlots_.empty()) {
+                index = freeSlots_.back();
+                freeSlots_.pop_back();
+            }
+            else {
+                index = static_cast<uint32_t>(slots_.grow_by(1) - slots_.begin());
+            }
+
+            Slot& slot = slots_[index];
+            slot.key = key;
+            slot.references = 1U;
+            slot.pointer.store(object.get(), std::memory_order_relaxed);
+            slot.object = std::move(object);
+            slotsByKey_.emplace(key, index);
+
+            return Handle { index, slot.generation.load(std::memory_order_relaxed) };
+        }
+
+        // Returns nullptr if handle is stale or was never given by this pool
+        T* resolve(Handle handle) const noexcept
+        {
+            if (!handle.isValid() || handle.index() >= slots_.size()) {
+                return nullptr;
+            }
+
+            const Slot& slot = slots_[handle.index()];
+
+            if (slot.generation.load(std::memory_order_acquire) != handle.generation()) {
+                return nullptr;
+            }
+
+            return slot.pointer.load(std::memory_order_relaxed);
+        }
+
+        // Returns strong reference to object, for cases where object must outlive it's handle
+        std::shared_ptr<T> object(Handle handle) const
+        {
+            tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+            if (resolve(handle) == nullptr) {
+                return nullptr;
+            }
+
+            return slots_[handle.index()].object;
+        }
+
+        // Returns false if handle was already stale
+        bool release(Handle handle, uint64_t currentFrame)
+        {
+            tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+            if (resolve(handle) == nullptr) {
+                return false;
+            }
+
+            Slot& slot = slots_[handle.index()];
+
+            if (--slot.references > 0) {
+                return true;
+            }
+
+            // Handle becomes stale right away, but object itself is kept alive until frames that might reference it are done
+            uint32_t nextGeneration = handle.generation() + 1U;
+            slot.generation.store(nextGeneration == 0U ? 1U : nextGeneration, std::memory_order_release);
+            slot.pointer.store(nullptr, std::memory_order_relaxed);
+
+            slotsByKey_.erase(slot.key);
+            retiredSlots_.emplace_back(handle.index(), currentFrame);
+
+            return true;
+        }
+
+        // Frees slots that was released at least retireFrames ago
+        void collect(uint64_t currentFrame)
+        {
+            std::vector<std::shared_ptr<T>> releasedObjects {};
+
+            {
+                tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+                while (!retiredSlots_.empty() && currentFrame - retiredSlots_.front().second >= retireFrames_) {
+                    uint32_t index = retiredSlots_.front().first;
+                    retiredSlots_.pop_front();
+
+                    releasedObjects.push_back(std::move(slots_[index].object));
+                    freeSlots_.push_back(index);
+                }
+            }
+
+            // Objects are destroyed outside of lock, because destruction of last reference might be expensive
+        }
+
+        // Amount of slots that currently hold objects, including retired ones
+        size_t size() const
+        {
+            tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+            return slots_.size() - freeSlots_.size();
+        }
+
+    private:
+        struct Slot {
+            std::shared_ptr<T> object = nullptr;
+            std::atomic<T*> pointer { nullptr };
+            std::atomic<uint32_t> generation { 1U };
+            uint32_t references = 0U;
+            uint64_t key = 0ULL;
+        };
+
+        const uint64_t retireFrames_;
+
+        tbb::concurrent_vector<Slot> slots_ {};
+        mutable tbb::queuing_mutex mutex_ {};
+        std::vector<uint32_t> freeSlots_ {};
+        std::unordered_map<uint64_t, uint32_t> slotsByKey_ {};
+        std::deque<std::pair<uint32_t, uint64_t>> retiredSlots_ {};
+    };
+
+} // namespace coffee
+
+#endif
@@ -0,0 +1,326 @@
+#ifndef COFFEE_INTERFACES_ASSET_ID
+#define COFFEE_INTERFACES_ASSET_ID
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Stolen directly from XXH3 single-file implementation
+typedef uint64_t XXH64_hash_t;
+
+namespace coffee {
+
+    namespace detail {
+
+        // Scalar constexpr implementation of XXH3_64bits with default secret and zero seed
+        // Produces exactly same hashes as XXH3 (which is used by virtual filesystem archives), but without any SIMD
+        // Reference: https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+        namespace xxh3 {
+
+            constexpr uint64_t kPrime32_1 = 0x9E3779B1ULL;
+            constexpr uint64_t kPrime32_2 = 0x85EBCA77ULL;
+            constexpr uint64_t kPrime32_3 = 0xC2B2AE3DULL;
+            constexpr uint64_t kPrime64_1 = 0x9E3779B185EBCA87ULL;
+            constexpr uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4FULL;
+            constexpr uint64_t kPrime64_3 = 0x165667B19E3779F9ULL;
+            constexpr uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ULL;
+            constexpr uint64_t kPrime64_5 = 0x27D4EB2F165667C5ULL;
+
+            constexpr size_t kSecretSize = 192;
+            constexpr size_t kStripeLength = 64;
+            constexpr size_t kSecretConsumeRate = 8;
+
+            constexpr uint8_t kSecret[kSecretSize] = {
+                0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb,
+                0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+                0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb,
+                0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+                0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+                0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+                0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+                0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+            };
+
+            constexpr uint32_t readLE32(const char* input) noexcept
+            {
+                return static_cast<uint32_t>(static_cast<uint8_t>(input[0])) | (static_cast<uint32_t>(static_cast<uint8_t>(input[1])) << 8) |
+                       (static_cast<uint32_t>(static_cast<uint8_t>(input[2])) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(input[3])) << 24);
+            }
+
+            constexpr uint64_t readLE64(const char* input) noexcept
+            {
+                return static_cast<uint64_t>(readLE32(input)) | (static_cast<uint64_t>(readLE32(input + 4)) << 32);
+            }
+
+            constexpr uint32_t readSecret32(size_t offset) noexcept
+            {
+                return static_cast<uint32_t>(kSecret[offset]) | (static_cast<uint32_t>(kSecret[offset + 1]) << 8) |
+                       (static_cast<uint32_t>(kSecret[offset + 2]) << 16) | (static_cast<uint32_t>(kSecret[offset + 3]) << 24);
+            }
+
+            constexpr uint64_t readSecret64(size_t offset) noexcept
+            {
+                return static_cast<uint64_t>(readSecret32(offset)) | (static_cast<uint64_t>(readSecret32(offset + 4)) << 32);
+            }
+
+            constexpr uint64_t rotateLeft(uint64_t value, uint32_t amount) noexcept { return (value << amount) | (value >> (64 - amount)); }
+
+            constexpr uint64_t byteSwap(uint64_t value) noexcept
+            {
+                value = ((value & 0x00000000FFFFFFFFULL) << 32) | ((value & 0xFFFFFFFF00000000ULL) >> 32);
+                value = ((value & 0x0000FFFF0000FFFFULL) << 16) | ((value & 0xFFFF0000FFFF0000ULL) >> 16);
+                return ((value & 0x00FF00FF00FF00FFULL) << 8) | ((value & 0xFF00FF00FF00FF00ULL) >> 8);
+            }
+
+            // Full 128 bit product folded into 64 bits, done through 32 bit halves because 128 bit integers aren't portable
+            constexpr uint64_t multiplyFold(uint64_t lhs, uint64_t rhs) noexcept
+            {
+                const uint64_t lowLow = (lhs & 0xFFFFFFFFULL) * (rhs & 0xFFFFFFFFULL);
+                const uint64_t highLow = (lhs >> 32) * (rhs & 0xFFFFFFFFULL);
+                const uint64_t lowHigh = (lhs & 0xFFFFFFFFULL) * (rhs >> 32);
+                const uint64_t highHigh = (lhs >> 32) * (rhs >> 32);
+
+                const uint64_t cross = (lowLow >> 32) + (highLow & 0xFFFFFFFFULL) + lowHigh;
+                const uint64_t upper = (highLow >> 32) + (cross >> 32) + highHigh;
+                const uint64_t lower = (cross << 32) | (lowLow & 0xFFFFFFFFULL);
+
+                return lower ^ upper;
+            }
+
+            constexpr uint64_t avalanche64(uint64_t hash) noexcept
+            {
+                hash ^= hash >> 33;
+                hash *= kPrime64_2;
+                hash ^= hash >> 29;
+                hash *= kPrime64_3;
+                return hash ^ (hash >> 32);
+            }
+
+            constexpr uint64_t avalanche(uint64_t hash) noexcept
+            {
+                hash ^= hash >> 37;
+                hash *= 0x165667919E3779F9ULL;
+                return hash ^ (hash >> 32);
+            }
+
+            constexpr uint64_t rrmxmx(uint64_t hash, uint64_t length) noexcept
+            {
+                hash ^= rotateLeft(hash, 49) ^ rotateLeft(hash, 24);
+                hash *= 0x9FB21C651E98DF25ULL;
+                hash ^= (hash >> 35) + length;
+                hash *= 0x9FB21C651E98DF25ULL;
+                return hash ^ (hash >> 28);
+            }
+
+            constexpr uint64_t mix16(const char* input, size_t secretOffset) noexcept
+            {
+                return multiplyFold(readLE64(input) ^ readSecret64(secretOffset), readLE64(input + 8) ^ readSecret64(secretOffset + 8));
+            }
+
+            constexpr uint64_t hash0To16(const char* input, size_t length) noexcept
+            {
+                if (length > 8) {
+                    const uint64_t low = readLE64(input) ^ (readSecret64(24) ^ readSecret64(32));
+                    const uint64_t high = readLE64(input + length - 8) ^ (readSecret64(40) ^ readSecret64(48));
+                    return avalanche(length + byteSwap(low) + high + multiplyFold(low, high));
+                }
+
+                if (length >= 4) {
+                    const uint64_t combined = static_cast<uint64_t>(readLE32(input + length - 4)) + (static_cast<uint64_t>(readLE32(input)) << 32);
+                    return rrmxmx(combined ^ (readSecret64(8) ^ readSecret64(16)), length);
+                }
+
+                if (length > 0) {
+                    const uint32_t first = static_cast<uint8_t>(input[0]);
+                    const uint32_t middle = static_cast<uint8_t>(input[length >> 1]);
+                    const uint32_t last = static_cast<uint8_t>(input[length - 1]);
+                    const uint32_t combined = (first << 16) | (middle << 24) | last | (static_cast<uint32_t>(length) << 8);
+                    return avalanche64(static_cast<uint64_t>(combined ^ (readSecret32(0) ^ readSecret32(4))));
+                }
+
+                return avalanche64(readSecret64(56) ^ readSecret64(64));
+            }
+
+            constexpr uint64_t hash17To128(const char* input, size_t length) noexcept
+            {
+                uint64_t accumulator = length * kPrime64_1;
+
+                if (length > 32) {
+                    if (length > 64) {
+                        if (length > 96) {
+                            accumulator += mix16(input + 48, 96);
+                            accumulator += mix16(input + length - 64, 112);
+                        }
+
+                        accumulator += mix16(input + 32, 64);
+                        accumulator += mix16(input + length - 48, 80);
+                    }
+
+                    accumulator += mix16(input + 16, 32);
+                    accumulator += mix16(input + length - 32, 48);
+                }
+
+                accumulator += mix16(input, 0);
+                accumulator += mix16(input + length - 16, 16);
+
+                return avalanche(accumulator);
+            }
+
+            constexpr uint64_t hash129To240(const char* input, size_t length) noexcept
+            {
+                constexpr size_t kMidStartOffset = 3;
+                constexpr size_t kMidLastOffset = 17;
+                constexpr size_t kSecretSizeMin = 136;
+
+                uint64_t accumulator = length * kPrime64_1;
+
+                for (size_t round = 0; round < 8; round++) {
+                    accumulator += mix16(input + 16 * round, 16 * round);
+                }
+
+                accumulator = avalanche(accumulator);
+
+                for (size_t round = 8; round < length / 16; round++) {
+                    accumulator += mix16(input + 16 * round, 16 * (round - 8) + kMidStartOffset);
+                }
+
+                accumulator += mix16(input + length - 16, kSecretSizeMin - kMidLastOffset);
+
+                return avalanche(accumulator);
+            }
+
+            constexpr void accumulateStripe(uint64_t (&accumulators)[8], const char* input, size_t secretOffset) noexcept
+            {
+                for (size_t lane = 0; lane < 8; lane++) {
+                    const uint64_t value = readLE64(input + 8 * lane);
+                    const uint64_t key = value ^ readSecret64(secretOffset + 8 * lane);
+
+                    accumulators[lane ^ 1] += value;
+                    accumulators[lane] += (key & 0xFFFFFFFFULL) * (key >> 32);
+                }
+            }
+
+            constexpr void scramble(uint64_t (&accumulators)[8]) noexcept
+            {
+                for (size_t lane = 0; lane < 8; lane++) {
+                    uint64_t accumulator = accumulators[lane];
+                    accumulator ^= accumulator >> 47;
+                    accumulator ^= readSecret64(kSecretSize - kStripeLength + 8 * lane);
+                    accumulators[lane] = accumulator * kPrime32_1;
+                }
+            }
+
+            constexpr uint64_t hashLong(const char* input, size_t length) noexcept
+            {
+                constexpr size_t kStripesPerBlock = (kSecretSize - kStripeLength) / kSecretConsumeRate;
+                constexpr size_t kBlockLength = kStripeLength * kStripesPerBlock;
+                constexpr size_t kLastStripeSecretOffset = 7;
+                constexpr size_t kMergeSecretOffset = 11;
+
+                uint64_t accumulators[8] = { kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3, kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1 };
+                const size_t amountOfBlocks = (length - 1) / kBlockLength;
+
+                for (size_t block = 0; block < amountOfBlocks; block++) {
+                    for (size_t stripe = 0; stripe < kStripesPerBlock; stripe++) {
+                        accumulateStripe(accumulators, input + block * kBlockLength + stripe * kStripeLength, stripe * kSecretConsumeRate);
+                    }
+
+                    scramble(accumulators);
+                }
+
+                const size_t amountOfStripes = ((length - 1) - kBlockLength * amountOfBlocks) / kStripeLength;
+
+                for (size_t stripe = 0; stripe < amountOfStripes; stripe++) {
+                    accumulateStripe(accumulators, input + amountOfBlocks * kBlockLength + stripe * kStripeLength, stripe * kSecretConsumeRate);
+                }
+
+                accumulateStripe(accumulators, input + length - kStripeLength, kSecretSize - kStripeLength - kLastStripeSecretOffset);
+
+                uint64_t result = length * kPrime64_1;
+
+                for (size_t pair = 0; pair < 4; pair++) {
+                    result += multiplyFold(
+                        accumulators[2 * pair] ^ readSecret64(kMergeSecretOffset + 16 * pair),
+                        accumulators[2 * pair + 1] ^ readSecret64(kMergeSecretOffset + 16 * pair + 8)
+                    );
+                }
+
+                return avalanche(result);
+            }
+
+            constexpr uint64_t digest(const char* input, size_t length) noexcept
+            {
+                if (length <= 16) {
+                    return hash0To16(input, length);
+                }
+
+                if (length <= 128) {
+                    return hash17To128(input, length);
+                }
+
+                if (length <= 240) {
+                    return hash129To240(input, length);
+                }
+
+                return hashLong(input, length);
+            }
+
+        } // namespace xxh3
+
+    } // namespace detail
+
+    // Precomputed identifier of asset, which is just XXH3 hash of it's path with view of path itself for error messages
+    // Can be built at compile time from string literals, so lookups through AssetManager and Filesystem cost only single map probe
+    // AssetId doesn't own path, so ids that must outlive their source string must be created through intern()
+    class AssetId {
+    public:
+        constexpr AssetId() noexcept = default;
+
+        constexpr AssetId(const char* path) noexcept : AssetId { std::string_view { path } } {}
+
+        constexpr AssetId(std::string_view path) noexcept : hash_ { detail::xxh3::digest(path.data(), path.size()) }, path_ { path } {}
+
+        // Hashed at runtime with vectorized XXH3
+        AssetId(const std::string& path) noexcept;
+        // Id would reference destroyed string, use intern() instead
+        AssetId(std::string&& path) = delete;
+
+        // Copies path into global table, so returned id stays valid for the rest of program lifetime
+        // Interning same path multiple times returns same id without additional allocations
+        static AssetId intern(std::string_view path);
+
+        constexpr XXH64_hash_t hash() const noexcept { return hash_; }
+
+        constexpr std::string_view path() const noexcept { return path_; }
+
+        constexpr bool operator==(const AssetId& other) const noexcept { return hash_ == other.hash_; }
+
+        constexpr bool operator!=(const AssetId& other) const noexcept { return hash_ != other.hash_; }
+
+    private:
+        constexpr AssetId(XXH64_hash_t hash, std::string_view path) noexcept : hash_ { hash }, path_ { path } {}
+
+        XXH64_hash_t hash_ = detail::xxh3::digest("", 0);
+        std::string_view path_ {};
+    };
+
+    namespace literals {
+
+        constexpr AssetId operator""_asset(const char* path, size_t length) noexcept { return AssetId { std::string_view { path, length } }; }
+
+    } // namespace literals
+
+} // namespace coffee
+
+namespace std {
+
+template <>
+struct hash<coffee::AssetId> {
+    size_t operator()(const coffee::AssetId& id) const noexcept { return static_cast<size_t>(id.hash()); }
+};
+
+} // namespace std
+
+#endif
@@ -1,20 +1,36 @@
 #ifndef COFFEE_INTERFACES_ASSET_MANAGER
 #define COFFEE_INTERFACES_ASSET_MANAGER
 
+#include <coffee/audio/buffer.hpp>
 #include <coffee/graphics/image.hpp>
 #include <coffee/graphics/mesh.hpp>
 #include <coffee/graphics/shader.hpp>
+#include <coffee/graphics/staging_ring.hpp>
 
+#include <coffee/interfaces/asset_handle.hpp>
 #include <coffee/interfaces/filesystem.hpp>
+#include <coffee/interfaces/mesh_format.hpp>
 #include <coffee/interfaces/scope_guard.hpp>
+#include <coffee/utils/latency_histogram.hpp>
+#include <coffee/utils/non_moveable.hpp>
 #include <coffee/utils/utils.hpp>
 
 #include <basis_universal/basisu_transcoder.h>
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/concurrent_hash_map.h>
+#include <oneapi/tbb/queuing_mutex.h>
+#include <oneapi/tbb/task_group.h>
 
+#include <array>
+#include <atomic>
+#include <deque>
+#include <future>
 #include <memory>
+#include <optional>
 #include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <variant>
 
 namespace coffee {
@@ -22,21 +38,48 @@ namespace coffee {
     class AssetManager;
     using AssetManagerPtr = std::shared_ptr<AssetManager>;
 
+    struct AssetManagerConfiguration {
+        // Size of persistently mapped staging ring in bytes, all uploads are sub-allocated from it
+        size_t stagingRingSize = 64ULL * 1024ULL * 1024ULL;
+        // Uploads that are bigger than this value will use dedicated staging buffer instead of ring
+        // Zero means half of staging ring size
+        size_t dedicatedStagingThreshold = 0ULL;
+        // Upper limit of bytes (both CPU and GPU) that cache can hold before evicting least recently used assets
+        // Zero means that cache is limited only by device heap budgets
+        size_t memoryBudget = 0ULL;
+        // Fraction of device-local heap budget after which cache starts evicting least recently used assets
+        float heapPressureThreshold = 0.9f;
+        // If set, cache will hold only weak references, so assets are destroyed once user releases last reference
+        // Expired entries are swept in update() or replaced when same asset is requested again
+        bool weakReferences = false;
+        // Amount of bytes of Basis mip levels that will be uploaded in each update() call, levels are transcoded in background beforehand
+        // Single level that is bigger than this value is uploaded alone in it's own call
+        // Zero disables streaming, so every mip level is uploaded before image is returned
+        size_t streamingBytesPerFrame = 0ULL;
+        // When streaming is enabled, mip levels with both dimensions less or equal to this value are uploaded right away
+        uint32_t streamingInitialExtent = 256U;
+        // Directory where transcoded Basis images are stored between launches, keyed by content, target format and transcoder version
+        // Empty string disables cache
+        std::string transcodeCachePath = {};
+        // Maximum amount of scheduled requests that are loaded at the same time, zero means amount of hardware threads
+        uint32_t schedulerConcurrency = 0U;
+    };
+
     // Q: Why not just use inheritance to simply all this info structs?
     // A: Designated initializers doesn't work well with inheritance, thus all fields repeatedly provided
 
     struct BytesLoadingInfo {
         // Filesystem as fallback loading method, if cache doesn't contain requested asset
         FilesystemPtr filesystem = nullptr;
-        // Path to requested asset
-        std::string path = {};
+        // Path to requested asset, id doesn't own path so source string must outlive this structure
+        AssetId path = {};
     };
 
     struct ShaderLoadingInfo {
         // Filesystem as fallback loading method, if cache doesn't contain requested asset
         FilesystemPtr filesystem = nullptr;
-        // Path to requested asset
-        std::string path = {};
+        // Path to requested asset, id doesn't own path so source string must outlive this structure
+        AssetId path = {};
         // Shader entrypoint, almost always it's just "main"
         std::string entrypoint = "main";
     };
@@ -44,68 +87,446 @@ namespace coffee {
     struct ImageLoadingInfo {
         // Filesystem as fallback loading method, if cache doesn't contain requested asset
         FilesystemPtr filesystem = nullptr;
-        // Path to requested asset
-        std::string path = {};
+        // Path to requested asset, id doesn't own path so source string must outlive this structure
+        AssetId path = {};
+        // If set, full mip chain will be generated on GPU for images that doesn't store it (.img)
+        // If image format doesn't support blitting, only first level is loaded and warning is written into log
+        bool generateMipmaps = true;
     };
 
     struct MeshLoadingInfo {
         // Filesystem as fallback loading method, if cache doesn't contain requested asset
         FilesystemPtr filesystem = nullptr;
-        // Path to requested asset
-        std::string path = {};
+        // Path to requested asset, id doesn't own path so source string must outlive this structure
+        AssetId path = {};
+        // If set, mesh will be returned right after geometry upload with placeholder textures
+        // Actual textures will be written into materials in background once they're uploaded
+        bool asyncTextures = false;
+        // If set, meshlets will be built for files that don't store them, which also reorders triangles inside submeshes
+        // Prefer building them with MeshOptimizer when packing, because this noticeably slows down loading of big meshes
+        bool buildMeshlets = false;
+        // If set, triangles and vertices will be reordered for post-transform cache and vertex fetch efficiency
+        // Intended for files that weren't processed by MeshOptimizer when packing, results are reported into log
+        bool optimizeGeometry = false;
+        // If set, clusters of triangles are additionally reordered to reduce overdraw, see MeshOptimizer::optimizeOverdraw()
+        // Same as above, this is intended for files that weren't processed when packing
+        bool optimizeOverdraw = false;
+        // If not zero, chain of up to this amount of LODs will be generated for files that don't store any
+        // Same as meshlets, LODs should be generated by MeshOptimizer when packing, because simplification is expensive
+        uint32_t amountOfLods = 0U;
+        // Layout of vertices on GPU, compact format must be decoded in shaders with AABB of each submesh
+        graphics::VertexFormat vertexFormat = graphics::VertexFormat::Full;
+        // If set, additional buffer with positions only is created for depth and shadow passes, see CommandBuffer::bindMeshPositions()
+        bool positionsStream = false;
     };
 
     struct SoundLoadingInfo {
         // Filesystem as fallback loading method, if cache doesn't contain requested asset
         FilesystemPtr filesystem = nullptr;
-        // Path to requested asset
-        std::string path = {};
+        // Path to requested asset, id doesn't own path so source string must outlive this structure
+        AssetId path = {};
     };
 
-    struct AudioStreamLoadingInfo {
+    struct PreloadEntry {
+        // Path to requested asset, it's interned by preload() so source string might be destroyed right after call
+        AssetId path = {};
+        // Type of requested asset, must match actual type of file
+        Filesystem::FileType type = Filesystem::FileType::RawBytes;
+    };
+
+    struct PreloadManifest {
+        // Filesystem that will be used for every entry
+        FilesystemPtr filesystem = nullptr;
+        // Entries are started in provided order, but might finish in any order
+        std::vector<PreloadEntry> entries = {};
+        // Maximum amount of entries that are loaded at the same time, zero means amount of hardware threads
+        // Loads are still using all threads for their internal work (e.g. mesh textures and Basis levels)
+        uint32_t concurrency = 0U;
+    };
+
+    struct LoadRequest {
         // Filesystem as fallback loading method, if cache doesn't contain requested asset
         FilesystemPtr filesystem = nullptr;
-        // Path to requested asset
-        std::string path = {};
+        // Path to requested asset, it's interned by schedule() so source string might be destroyed right after call
+        AssetId path = {};
+        // Type of requested asset, must match actual type of file
+        Filesystem::FileType type = Filesystem::FileType::RawBytes;
+        // Requests with higher priority are started first, e.g. negative distance to camera
+        float priority = 0.0f;
+    };
+
+    // Snapshot of AssetManager counters, gathering it never blocks any loads
+    struct AssetStatistics {
+        static constexpr size_t kAmountOfFileTypes = static_cast<size_t>(Filesystem::FileType::OGG) + 1;
+        static constexpr size_t kAmountOfStages = 5;
+
+        enum class Stage : uint8_t {
+            // Reading file from filesystem, includes decompression of archive entries
+            Read = 0,
+            // Decompression of transcode cache entries
+            Decompress = 1,
+            // Transcoding of Basis levels and conversion of audio samples
+            Transcode = 2,
+            // Recording and submitting of upload commands
+            Staging = 3,
+            // Time between upload submit and it's completion on GPU
+            GpuWait = 4,
+        };
+
+        struct TypeStatistics {
+            // Requests that was served without reading file, including ones that waited for load of somebody else
+            uint64_t hits = 0ULL;
+            uint64_t misses = 0ULL;
+            size_t cpuBytes = 0ULL;
+            size_t gpuBytes = 0ULL;
+        };
+
+        // Indexed by Filesystem::FileType, images and sounds are always accounted as RawImage and WAV
+        std::array<TypeStatistics, kAmountOfFileTypes> types {};
+        // Indexed by Stage
+        std::array<LatencyHistogram::Summary, kAmountOfStages> stages {};
+        size_t inFlightLoads = 0ULL;
+        uint64_t failedLoads = 0ULL;
+
+        // Serializes snapshot into single JSON object
+        std::string toJson() const;
+    };
+
+    class PreloadProgress;
+    using PreloadProgressPtr = std::shared_ptr<PreloadProgress>;
+
+    // Thread-safe progress of AssetManager::preload
+    // Loaded assets are kept alive by this object, so they wouldn't be evicted before user requests them
+    class PreloadProgress : NonMoveable {
+    public:
+        inline size_t loadedItems() const noexcept { return loadedItems_.load(std::memory_order_relaxed); }
+
+        inline size_t failedItems() const noexcept { return failedItems_.load(std::memory_order_relaxed); }
+
+        inline size_t totalItems() const noexcept { return totalItems_; }
+
+        // Bytes are measured by size of files, so progress is accurate even for assets that are expanded after loading
+        inline size_t loadedBytes() const noexcept { return loadedBytes_.load(std::memory_order_relaxed); }
+
+        inline size_t totalBytes() const noexcept { return totalBytes_; }
+
+        inline bool isDone() const noexcept { return loadedItems() + failedItems() == totalItems_; }
+
+        // Becomes ready once every entry is processed, contains first exception if any of entries failed
+        const std::shared_future<void> completion;
+
+    private:
+        PreloadProgress(std::shared_future<void>&& completion, size_t totalItems, size_t totalBytes);
+
+        const size_t totalItems_;
+        const size_t totalBytes_;
+        std::atomic<size_t> loadedItems_ { 0ULL };
+        std::atomic<size_t> failedItems_ { 0ULL };
+        std::atomic<size_t> loadedBytes_ { 0ULL };
+        std::shared_ptr<void> keepAlive_ = nullptr;
+
+        friend class AssetManager;
+    };
+
+    class LoadTicket;
+    using LoadTicketPtr = std::shared_ptr<LoadTicket>;
+
+    // Thread-safe handle of request that was scheduled through AssetManager::schedule
+    // Loaded asset is kept alive by this object, so it can be received through regular load functions without reading it again
+    class LoadTicket : NonMoveable {
+    public:
+        enum class Status : uint8_t {
+            // Waiting in queue, nothing was done yet
+            Queued = 0,
+            // File is being read, request can still be cancelled before decoding starts
+            Reading = 1,
+            // Decoding or uploading, cannot be cancelled anymore
+            Loading = 2,
+            Loaded = 3,
+            Failed = 4,
+            Cancelled = 5,
+        };
+
+        inline Status status() const noexcept { return status_.load(std::memory_order_acquire); }
+
+        inline float priority() const noexcept { return priority_.load(std::memory_order_relaxed); }
+
+        // Takes effect when next request is picked from queue, requests that are already started aren't affected
+        inline void setPriority(float priority) noexcept { priority_.store(priority, std::memory_order_relaxed); }
+
+        // Returns false if decoding was already started, in which case request will finish as usual
+        bool cancel();
+
+        // Becomes ready once request is loaded, failed or cancelled, contains exception if request failed
+        const std::shared_future<void> completion;
+
+    private:
+        LoadTicket(const LoadRequest& request, std::shared_future<void>&& completion);
+
+        // Only one of cancel() and loader might finish request, this decides which one
+        inline bool transition(Status from, Status to) noexcept { return status_.compare_exchange_strong(from, to, std::memory_order_acq_rel); }
+
+        const FilesystemPtr filesystem_;
+        const AssetId path_;
+        const Filesystem::FileType type_;
+        std::atomic<float> priority_;
+        std::atomic<Status> status_ { Status::Queued };
+        std::promise<void> promise_ {};
+        std::shared_ptr<void> keepAlive_ = nullptr;
+
+        friend class AssetManager;
     };
 
     // Asynchronous loader for coffee::Filesystem
     // Calling any of functions below is thread-safe unless otherwise specified
     class AssetManager {
     public:
-        ~AssetManager() noexcept = default;
+        ~AssetManager() noexcept;
 
-        static AssetManagerPtr create(const graphics::DevicePtr& device);
+        static AssetManagerPtr create(const graphics::DevicePtr& device, const AssetManagerConfiguration& configuration = {});
 
-        std::vector<uint8_t> loadBytes(const BytesLoadingInfo& loadingInfo);
+        // Returned buffer is shared with cache, so it must never be modified
+        ByteBufferPtr loadBytes(const BytesLoadingInfo& loadingInfo);
         graphics::ShaderPtr loadShader(const ShaderLoadingInfo& loadingInfo);
         graphics::ImagePtr loadImage(const ImageLoadingInfo& loadingInfo);
         graphics::MeshPtr loadMesh(const MeshLoadingInfo& loadingInfo);
-        void loadSound(const SoundLoadingInfo& loadingInfo);
-        void loadAudioStream(const AudioStreamLoadingInfo& loadingInfo);
+        // OpenAL context must be applied before loading any sound
+        audio::BufferPtr loadSound(const SoundLoadingInfo& loadingInfo);
+        // Decodes all sounds in parallel, result is in same order as provided infos
+        std::vector<audio::BufferPtr> loadSounds(const std::vector<SoundLoadingInfo>& loadingInfos);
+
+        // Same as load functions above, but errors are returned as codes instead of exceptions
+        // Missing files and mismatched types are detected before loading starts, so probing for optional assets is cheap
+        Expected<ByteBufferPtr> tryLoadBytes(const BytesLoadingInfo& loadingInfo);
+        Expected<graphics::ShaderPtr> tryLoadShader(const ShaderLoadingInfo& loadingInfo);
+        Expected<graphics::ImagePtr> tryLoadImage(const ImageLoadingInfo& loadingInfo);
+        Expected<graphics::MeshPtr> tryLoadMesh(const MeshLoadingInfo& loadingInfo);
+        Expected<audio::BufferPtr> tryLoadSound(const SoundLoadingInfo& loadingInfo);
+
+        // Loads every entry of manifest in background and returns right away
+        // Images and meshes are read by separate pipeline stage ahead of decoding and uploading, other types are loaded as a whole
+        PreloadProgressPtr preload(const PreloadManifest& manifest);
+        // Queues request that will be loaded in background once there's no requests with higher priority
+        // Decoded data is uploaded by thread that decoded it, so requests never wait for each other after they're started
+        LoadTicketPtr schedule(const LoadRequest& request);
 
         // Thread-safe remove function, may cause blocking
-        void removeFromCache(const std::string& path);
+        void removeFromCache(const AssetId& id);
+
+        // Pinned assets are never evicted, every pin must be followed by unpin
+        void pin(const AssetId& id);
+        void unpin(const AssetId& id);
+
+        // Assets that was declared as required by loader of this asset (e.g. textures of mesh), empty if asset was never loaded
+        // Dependencies are remembered after eviction, so reloading asset will start loading them before asset itself is parsed
+        std::vector<AssetId> dependencies(const AssetId& id);
+        // Resident assets that declared this asset as their dependency
+        std::vector<AssetId> dependents(const AssetId& id);
+
+        // Same as load functions, but returns handle that keeps asset alive until it's released
+        // Acquiring same asset multiple times returns same handle, every acquire must be followed by release
+        TextureHandle acquireTexture(const ImageLoadingInfo& loadingInfo);
+        MeshHandle acquireMesh(const MeshLoadingInfo& loadingInfo);
+        ShaderHandle acquireShader(const ShaderLoadingInfo& loadingInfo);
+
+        void release(TextureHandle handle);
+        void release(MeshHandle handle);
+        void release(ShaderHandle handle);
+
+        // Lock-free and doesn't touch any reference counters, so it's intended to be used in per-frame code
+        // Returns nullptr if handle was released, otherwise pointer stays valid for Device::kMaxOperationsInFlight frames after release
+        inline graphics::Image* resolve(TextureHandle handle) const noexcept { return textureHandles_.resolve(handle); }
+
+        inline graphics::Mesh* resolve(MeshHandle handle) const noexcept { return meshHandles_.resolve(handle); }
+
+        inline graphics::ShaderModule* resolve(ShaderHandle handle) const noexcept { return shaderHandles_.resolve(handle); }
+
+        // Must be called once per frame, reclaims staging memory and evicts unreferenced assets when memory budget is exceeded
+        // Assets are evicted only after they wasn't referenced outside of cache for Device::kMaxOperationsInFlight frames
+        // When streaming is enabled, also uploads mip levels that were transcoded in background within streamingBytesPerFrame
+        void update();
+
+        // Counters are always collected, so this can be called at any time without affecting loads
+        AssetStatistics statistics() const noexcept;
 
     private:
-        AssetManager(const graphics::DevicePtr& device);
+        AssetManager(const graphics::DevicePtr& device, const AssetManagerConfiguration& configuration);
+
+        struct Asset;
+        struct Residency;
+        struct StreamingImage;
+
+        // Last used frame is copied when candidate is collected, because loader threads keep updating it during eviction
+        using EvictionCandidate = std::tuple<XXH64_hash_t, std::shared_ptr<Residency>, uint64_t>;
+
+        // Returns cached asset or loads it through loadFunction
+        // Only one thread will execute loadFunction for same hash, others will wait for it's result
+        template <typename Fx>
+        Asset acquireAsset(XXH64_hash_t hash, Fx&& loadFunction);
+        bool findCachedAsset(XXH64_hash_t hash, Asset& asset);
+        Filesystem::Entry requestMetadata(const FilesystemPtr& filesystem, const AssetId& id);
+        std::vector<uint8_t> readContent(const FilesystemPtr& filesystem, const AssetId& id);
+        ByteBufferPtr readBuffer(const FilesystemPtr& filesystem, const AssetId& id);
+        // Checks everything that can be checked without reading file, returns nothing if asset can be loaded
+        std::optional<AssetError> probeAsset(
+            const FilesystemPtr& filesystem,
+            const AssetId& id,
+            Filesystem::FileType cachedType,
+            Filesystem::FileType firstType,
+            Filesystem::FileType secondType
+        );
+        template <typename Fx>
+        auto tryLoadAsset(std::optional<AssetError> probeResult, Fx&& loadFunction) -> Expected<decltype(loadFunction())>;
+        void measureAsset(Asset& asset);
+        void forgetAsset(XXH64_hash_t hash);
+        // Must be called under residency lock, so counters always match with residency map
+        void trackResidentBytes(const Residency& residency, bool resident) noexcept;
+        void recordCacheHit(Filesystem::FileType type) noexcept;
+        // Replaces previously declared dependencies of asset, must be called only when asset is successfully loaded
+        void declareDependencies(const AssetId& id, const std::vector<std::string>& paths);
+        // Removes reverse edges of forgotten asset, dependencies without any dependents will be evicted by update()
+        void releaseDependencies(XXH64_hash_t hash);
+        // Returns bytes that was freed, orphans that are still in flight are kept for next frames
+        size_t evictOrphanedAssets(const std::vector<EvictionCandidate>& candidates);
+
+        inline LatencyHistogram& stageLatency(AssetStatistics::Stage stage) noexcept { return stageLatencies_[static_cast<size_t>(stage)]; }
+
+        void sweepExpiredAssets();
+        std::shared_ptr<void> loadEntry(const FilesystemPtr& filesystem, const PreloadEntry& entry);
+        void streamImages();
+        // Transcodes next mip level of image in background, image is queued for upload in update() once level is ready
+        void transcodeStreamingLevel(std::shared_ptr<StreamingImage> streamingImage);
+        // Runs until scheduler queue is empty, amount of running loops is limited by schedulerConcurrency_
+        void runScheduledLoads();
+        // Returns nullptr and releases worker slot if queue is empty
+        LoadTicketPtr popScheduledLoad();
+        void loadScheduledRequest(LoadTicket& ticket);
+
         void createMissingTexture();
         void selectOneChannel();
         void selectTwoChannels();
         void selectThreeChannels();
         void selectFourChannels();
 
-        graphics::MeshPtr loadMesh(const FilesystemPtr& filesystem, const std::string& path);
-        std::string readMaterialName(utils::ReaderStream& stream);
-
-        graphics::ImagePtr loadRawImage(std::vector<uint8_t>& rawBytes);
-        graphics::ImagePtr loadBasisImage(std::vector<uint8_t>& rawBytes);
+        std::vector<graphics::ImageViewPtr> loadTextures(const FilesystemPtr& filesystem, const std::vector<std::string>& paths);
+        void writeTextures(
+            const graphics::MeshPtr& mesh,
+            const std::vector<MeshData::SubMesh>& subMeshesData,
+            const std::vector<std::string>& paths,
+            const std::vector<graphics::ImageViewPtr>& textures
+        );
+
+        struct MeshUpload;
+
+        // Same split as for images, geometry is parsed and written into staging memory during decoding
+        // Textures are loaded by decoding as well unless they're asynchronous, so upload only submits copies and assembles mesh
+        MeshUpload decodeMesh(const MeshLoadingInfo& loadingInfo, const ByteBufferPtr& meshBytes);
+        graphics::MeshPtr submitMeshUpload(MeshUpload&& upload);
+
+        struct ImageUpload;
+
+        // Decoding is done fully on CPU (including staging writes), so it can run in parallel with anything
+        // Upload only records and submits commands, which makes it cheap enough to be done in serial pipeline stage
+        ImageUpload decodeImage(Filesystem::FileType type, std::vector<uint8_t>& rawBytes, bool generateMipmaps);
+        ImageUpload decodeRawImage(std::vector<uint8_t>& rawBytes, bool generateMipmaps);
+        ImageUpload decodeBasisImage(std::vector<uint8_t>& rawBytes);
+        graphics::ImagePtr submitImageUpload(ImageUpload&& upload);
+        // Transcodes levels [baseMipLevel, baseMipLevel + levelCount) of every face into staging memory
+        // If transcodedBytes provided, it will also receive copy of transcoded levels
+        graphics::StagingRegion transcodeBasisLevels(
+            basist::ktx2_transcoder& transcoder,
+            basist::transcoder_texture_format format,
+            uint32_t baseMipLevel,
+            uint32_t levelCount,
+            std::vector<VkBufferImageCopy>& copyRegions,
+            std::vector<uint8_t>* transcodedBytes
+        );
+        // Writes copy regions of levels [baseMipLevel, baseMipLevel + levelCount) of every face and returns their total size
+        // Offsets are relative to beginning of transcoded data, faces of same level are placed next to each other
+        size_t layoutBasisLevels(
+            const basist::ktx2_transcoder& transcoder,
+            basist::transcoder_texture_format format,
+            uint32_t baseMipLevel,
+            uint32_t levelCount,
+            std::vector<VkBufferImageCopy>& copyRegions
+        );
+        // Transcodes every region in parallel, output must hold at least size returned by layoutBasisLevels
+        void transcodeBasisRegions(
+            basist::ktx2_transcoder& transcoder,
+            basist::transcoder_texture_format format,
+            const std::vector<VkBufferImageCopy>& copyRegions,
+            uint8_t* output
+        );
+        std::string transcodeCacheFilename(XXH64_hash_t contentHash, VkFormat format) const;
+        // Returns nothing if image isn't in transcode cache or entry is invalid
+        std::optional<ImageUpload> loadCachedBasisImage(XXH64_hash_t contentHash, VkFormat imageFormat, basist::transcoder_texture_format format);
+        void storeCachedBasisImage(
+            XXH64_hash_t contentHash,
+            const graphics::ImageConfiguration& imageConfiguration,
+            const std::vector<VkBufferImageCopy>& copyRegions,
+            const std::vector<uint8_t>& transcodedBytes
+        );
+        audio::BufferPtr loadWaveSound(const ByteBuffer& rawBytes);
+        // Whole stream is decoded into single buffer, long music tracks will take proportional amount of memory
+        audio::BufferPtr loadOggSound(const ByteBuffer& rawBytes);
+
+        // Both functions doesn't wait for GPU, ownership of resources will be transferred to graphics queue if required
+        // Only mip levels in range [baseMipLevel, baseMipLevel + levelCount) will be transitioned, previous content of them is discarded
+        void uploadImage(
+            graphics::StagingRegion&& stagingRegion,
+            const graphics::ImagePtr& image,
+            std::vector<VkBufferImageCopy>&& copyRegions,
+            uint32_t baseMipLevel,
+            uint32_t levelCount
+        );
+        // Replaces single mip level of image that might be sampled by frames in flight right now
+        // Level is expected to be in shader read-only layout, graphics queue stops reading it before copy and resumes after it
+        void uploadStreamedLevel(
+            graphics::StagingRegion&& stagingRegion,
+            const graphics::ImagePtr& image,
+            std::vector<VkBufferImageCopy>&& copyRegions,
+            uint32_t mipLevel
+        );
+        // Uploads first mip level and generates every other level from it with blits on graphics queue
+        void uploadImageWithMipmaps(
+            graphics::StagingRegion&& stagingRegion,
+            const graphics::ImagePtr& image,
+            const VkBufferImageCopy& copyRegion,
+            VkFilter filter
+        );
+        void recordMipmapsGeneration(const graphics::CommandBuffer& commandBuffer, const graphics::ImagePtr& image, VkFilter filter);
+        // Returns false if format cannot be used for mipmap generation, otherwise writes best supported filter
+        bool selectMipmapFilter(VkFormat format, VkFilter& filter);
+        void uploadBuffers(graphics::StagingRegion&& stagingRegion, const std::vector<std::pair<graphics::BufferPtr, VkBufferCopy>>& copyRegions);
 
         VkFormat channelsToVkFormat(uint32_t amountOfChannels, bool compressed);
         basist::transcoder_texture_format channelsToBasisuFormat(uint32_t amountOfChannels);
 
+        struct Residency {
+            static constexpr uint64_t kReferenced = std::numeric_limits<uint64_t>::max();
+
+            Filesystem::FileType type = Filesystem::FileType::RawBytes;
+            std::weak_ptr<void> object {};
+            size_t cpuBytes = 0ULL;
+            size_t gpuBytes = 0ULL;
+            std::atomic<uint64_t> lastUsedFrame { 0ULL };
+            std::atomic<uint32_t> pinCount { 0U };
+            // Frame where asset was first seen without any references outside of cache, only accessed in update()
+            uint64_t unreferencedSince = kReferenced;
+        };
+
+        struct DependencyNode {
+            // Interned, so it can be returned to user without copying path
+            AssetId id {};
+            std::vector<AssetId> dependencies {};
+            std::unordered_set<XXH64_hash_t> dependents {};
+        };
+
         struct Asset {
-            static Asset create(std::shared_ptr<std::vector<uint8_t>> copyBytes) { return { Filesystem::FileType::RawBytes, std::move(copyBytes) }; }
+            static Asset create(ByteBufferPtr bytes)
+            {
+                return { Filesystem::FileType::RawBytes, std::const_pointer_cast<ByteBuffer>(std::move(bytes)) };
+            }
 
             static Asset create(graphics::ShaderPtr shader) { return { Filesystem::FileType::Shader, std::move(shader) }; }
 
@@ -113,8 +534,13 @@ namespace coffee {
 
             static Asset create(graphics::ImagePtr image) { return { Filesystem::FileType::RawImage, std::move(image) }; }
 
+            static Asset create(audio::BufferPtr sound) { return { Filesystem::FileType::WAV, std::move(sound) }; }
+
             Filesystem::FileType type;
             std::shared_ptr<void> actualObject;
+            // Used instead of actualObject when weak references are enabled, actualObject is set only while asset is pinned
+            std::weak_ptr<void> weakObject = {};
+            std::shared_ptr<Residency> residency = nullptr;
         };
 
         struct CompressionTypes {
@@ -129,33 +555,110 @@ namespace coffee {
             basist::transcoder_texture_format basisFourChannels = basist::transcoder_texture_format::cTFTotalTextureFormats;
         };
 
-        struct MeshMetadata {
-            graphics::AABB aabb;
-            uint32_t verticesOffset;
-            uint32_t verticesSize;
-            uint32_t indicesOffset;
-            uint32_t indicesSize;
+        struct StreamingImage {
+            std::weak_ptr<graphics::Image> image {};
+            // Transcoder references this bytes, so they must be kept alive until every level is uploaded
+            std::vector<uint8_t> rawBytes {};
+            std::unique_ptr<basist::ktx2_transcoder> transcoder = nullptr;
+            basist::transcoder_texture_format format = basist::transcoder_texture_format::cTFTotalTextureFormats;
+            // Next mip level that will be uploaded, levels are streamed from least detailed to most detailed
+            uint32_t nextMipLevel = 0U;
+            // Next mip level transcoded in background, offsets of copy regions are relative to beginning of transcoded bytes
+            std::vector<uint8_t> transcodedBytes {};
+            std::vector<VkBufferImageCopy> copyRegions {};
         };
 
-        struct MaterialMetadata {
-            graphics::Materials* materials;
-            std::string name;
-            TextureType type;
+        struct ImageUpload {
+            graphics::ImagePtr image;
+            graphics::StagingRegion stagingRegion;
+            // Offsets are relative to beginning of staging region
+            std::vector<VkBufferImageCopy> copyRegions;
+            uint32_t residentMipLevel;
+            // If set, only first level is uploaded and others are generated from it
+            bool generateMipmaps;
+            VkFilter mipmapFilter;
+            std::unique_ptr<StreamingImage> streamingImage;
         };
 
-        struct MipmapInformation {
-            size_t bufferOffset = 0;
-            uint32_t width = 0;
-            uint32_t height = 0;
+        struct MeshUpload {
+            FilesystemPtr filesystem;
+            AssetId path;
+            bool asyncTextures;
+            graphics::VertexFormat vertexFormat;
+            uint32_t indexSize;
+            std::vector<MeshData::SubMesh> subMeshes;
+            std::vector<graphics::Meshlet> meshlets;
+            graphics::BufferPtr verticesBuffer;
+            graphics::BufferPtr indicesBuffer;
+            graphics::BufferPtr positionsBuffer;
+            graphics::StagingRegion stagingRegion;
+            // Offsets are relative to beginning of staging region
+            std::vector<std::pair<graphics::BufferPtr, VkBufferCopy>> copyRegions;
+            // Sorted and unique, textures are empty if they're loaded asynchronously
+            std::vector<std::string> texturePaths;
+            std::vector<graphics::ImageViewPtr> textures;
         };
 
         graphics::DevicePtr device_;
+        const size_t memoryBudget_;
+        const float heapPressureThreshold_;
+        const bool weakReferences_;
+        const size_t streamingBytesPerFrame_;
+        const uint32_t streamingInitialExtent_;
+        const std::string transcodeCachePath_;
+        const uint32_t schedulerConcurrency_;
+        graphics::StagingRingPtr stagingRing_;
         graphics::ImagePtr missingImage_;
         graphics::ImageViewPtr missingTexture_;
         CompressionTypes compressionTypes_ {};
 
         using HashAccessor = tbb::concurrent_hash_map<XXH64_hash_t, Asset>::const_accessor;
         tbb::concurrent_hash_map<XXH64_hash_t, Asset> cache_ {};
+
+        // Iterating over concurrent_hash_map isn't safe with concurrent insertions, so residency is tracked separately
+        std::atomic<uint64_t> currentFrame_ { 0ULL };
+        tbb::queuing_mutex residencyMutex_ {};
+        std::unordered_map<XXH64_hash_t, std::shared_ptr<Residency>> residency_ {};
+
+        using PendingAccessor = tbb::concurrent_hash_map<XXH64_hash_t, std::shared_future<Asset>>::accessor;
+        tbb::concurrent_hash_map<XXH64_hash_t, std::shared_future<Asset>> pendingLoads_ {};
+
+        tbb::task_group backgroundTasks_ {};
+
+        // Queue is unordered because priorities are changed from outside, so highest one is searched on every pop
+        tbb::queuing_mutex schedulerMutex_ {};
+        std::vector<LoadTicketPtr> scheduledLoads_ {};
+        uint32_t activeSchedulerWorkers_ = 0U;
+
+        // Edges are kept for every asset that was ever loaded, which is cheap compared to assets themselves
+        tbb::queuing_mutex dependencyMutex_ {};
+        std::unordered_map<XXH64_hash_t, DependencyNode> dependencyGraph_ {};
+        std::vector<XXH64_hash_t> orphanedAssets_ {};
+
+        tbb::queuing_mutex streamingMutex_ {};
+        // Only images which next level is already transcoded, others are owned by their background task
+        std::deque<std::shared_ptr<StreamingImage>> streamingImages_ {};
+
+        // OpenAL error state is shared by whole context, so buffer creation and upload are serialized while decoding is not
+        tbb::queuing_mutex audioMutex_ {};
+
+        struct TypeCounters {
+            std::atomic<uint64_t> hits { 0ULL };
+            std::atomic<uint64_t> misses { 0ULL };
+            std::atomic<size_t> cpuBytes { 0ULL };
+            std::atomic<size_t> gpuBytes { 0ULL };
+        };
+
+        std::array<TypeCounters, AssetStatistics::kAmountOfFileTypes> typeCounters_ {};
+        // GPU wait is measured by staging ring instead
+        std::array<LatencyHistogram, AssetStatistics::kAmountOfStages - 1> stageLatencies_ {};
+        std::atomic<size_t> inFlightLoads_ { 0ULL };
+        std::atomic<uint64_t> failedLoads_ { 0ULL };
+
+        // Handles are holding strong references, so assets behind them are never evicted
+        HandlePool<graphics::Image> textureHandles_ { graphics::Device::kMaxOperationsInFlight };
+        HandlePool<graphics::Mesh> meshHandles_ { graphics::Device::kMaxOperationsInFlight };
+        HandlePool<graphics::ShaderModule> shaderHandles_ { graphics::Device::kMaxOperationsInFlight };
     };
 
 } // namespace coffee
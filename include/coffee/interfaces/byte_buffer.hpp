@@ -0,0 +1,49 @@
+#ifndef COFFEE_INTERFACES_BYTE_BUFFER
+#define COFFEE_INTERFACES_BYTE_BUFFER
+
+#include <coffee/utils/non_moveable.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace coffee {
+
+    class ByteBuffer;
+    using ByteBufferPtr = std::shared_ptr<const ByteBuffer>;
+
+    // Immutable view over bytes that either owns them or keeps their actual owner alive
+    // Allows to share same bytes between cache and users without copying them, e.g. region of mapped archive
+    class ByteBuffer : NonMoveable {
+    public:
+        // Takes ownership over provided bytes
+        ByteBuffer(std::vector<uint8_t>&& bytes) noexcept;
+        // Aliases memory of other object, which will be kept alive as long as this buffer is alive
+        ByteBuffer(const uint8_t* data, size_t size, std::shared_ptr<const void> owner) noexcept;
+        ~ByteBuffer() noexcept = default;
+
+        inline const uint8_t* data() const noexcept { return data_; }
+
+        inline size_t size() const noexcept { return size_; }
+
+        inline bool empty() const noexcept { return size_ == 0; }
+
+        inline const uint8_t* begin() const noexcept { return data_; }
+
+        inline const uint8_t* end() const noexcept { return data_ + size_; }
+
+        inline const uint8_t& operator[](size_t index) const noexcept { return data_[index]; }
+
+        // Returns true if bytes are owned by this buffer, false if they're aliased from other object
+        inline bool ownsStorage() const noexcept { return owner_ == nullptr; }
+
+    private:
+        std::vector<uint8_t> storage_ {};
+        std::shared_ptr<const void> owner_ = nullptr;
+        const uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+    };
+
+} // namespace coffee
+
+#endif
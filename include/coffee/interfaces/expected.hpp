@@ -0,0 +1,111 @@
+#ifndef COFFEE_INTERFACES_EXPECTED
+#define COFFEE_INTERFACES_EXPECTED
+
+#include <coffee/utils/log.hpp>
+
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace coffee {
+
+    // Error codes of non-throwing functions, each one matches type of exception that would be thrown by throwing version
+    enum class AssetError : uint8_t {
+        FileNotFound = 0,
+        InvalidFileType = 1,
+        InvalidFilesystem = 2,
+        DecompressionFailure = 3,
+        TypeMismatch = 4,
+        NotInCache = 5,
+        InvalidRequest = 6,
+        ImplementationFailure = 7,
+    };
+
+    constexpr std::string_view errorToString(AssetError error) noexcept
+    {
+        switch (error) {
+            case AssetError::FileNotFound:
+                return "FileNotFound";
+            case AssetError::InvalidFileType:
+                return "InvalidFileType";
+            case AssetError::InvalidFilesystem:
+                return "InvalidFilesystem";
+            case AssetError::DecompressionFailure:
+                return "DecompressionFailure";
+            case AssetError::TypeMismatch:
+                return "TypeMismatch";
+            case AssetError::NotInCache:
+                return "NotInCache";
+            case AssetError::InvalidRequest:
+                return "InvalidRequest";
+            default:
+                return "ImplementationFailure";
+        }
+    }
+
+    // Either value or error code, error path never allocates anything
+    template <typename T>
+    class Expected {
+    public:
+        Expected(const T& value) : storage_ { std::in_place_index<0>, value } {}
+
+        Expected(T&& value) noexcept(std::is_nothrow_move_constructible_v<T>) : storage_ { std::in_place_index<0>, std::move(value) } {}
+
+        Expected(AssetError error) noexcept : storage_ { std::in_place_index<1>, error } {}
+
+        inline bool hasValue() const noexcept { return storage_.index() == 0; }
+
+        inline explicit operator bool() const noexcept { return hasValue(); }
+
+        inline T& value() & noexcept
+        {
+            checkValue();
+            return *std::get_if<0>(&storage_);
+        }
+
+        inline const T& value() const& noexcept
+        {
+            checkValue();
+            return *std::get_if<0>(&storage_);
+        }
+
+        inline T&& value() && noexcept
+        {
+            checkValue();
+            return std::move(*std::get_if<0>(&storage_));
+        }
+
+        inline AssetError error() const noexcept
+        {
+            // Assert message is formatted eagerly, so it's only reached when check already failed
+            if (hasValue()) {
+                COFFEE_ASSERT(false, "Error was requested from Expected that holds value.");
+            }
+
+            return *std::get_if<1>(&storage_);
+        }
+
+        inline T* operator->() noexcept { return &value(); }
+
+        inline const T* operator->() const noexcept { return &value(); }
+
+        inline T& operator*() & noexcept { return value(); }
+
+        inline const T& operator*() const& noexcept { return value(); }
+
+    private:
+        inline void checkValue() const noexcept
+        {
+            if (!hasValue()) {
+                COFFEE_ASSERT(false, "Value was requested from Expected that holds error {}.", errorToString(*std::get_if<1>(&storage_)));
+            }
+        }
+
+        std::variant<T, AssetError> storage_;
+    };
+
+} // namespace coffee
+
+#endif
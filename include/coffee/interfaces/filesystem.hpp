@@ -1,6 +1,9 @@
 #ifndef COFFEE_INTERFACES_FILESYSTEM
 #define COFFEE_INTERFACES_FILESYSTEM
 
+#include <coffee/interfaces/asset_id.hpp>
+#include <coffee/interfaces/byte_buffer.hpp>
+#include <coffee/interfaces/expected.hpp>
 #include <coffee/utils/non_moveable.hpp>
 #include <coffee/utils/utils.hpp>
 
@@ -14,15 +17,15 @@
 
 // Stolen directly from ZSTD single-file implementation
 typedef struct ZSTD_DCtx_s ZSTD_DCtx;
-// Stolen directly fron XXH3 single-file implementation
-typedef uint64_t XXH64_hash_t;
 
 namespace coffee {
 
     class Filesystem;
     using FilesystemPtr = std::shared_ptr<Filesystem>;
 
-    class Filesystem : NonMoveable {
+    class Filesystem
+        : NonMoveable
+        , public std::enable_shared_from_this<Filesystem> {
     public:
         // Virtual filesystem support some internal types as mandatory
         // This required because of type checking inside and for better error handling
@@ -59,11 +62,21 @@ namespace coffee {
 
         static FilesystemPtr create(const std::string& path);
 
-        virtual bool contains(const std::string& path) const noexcept = 0;
+        // Every function accepts either string path (hashed on each call) or precomputed AssetId
+        virtual bool contains(const AssetId& id) const noexcept = 0;
 
-        virtual Filesystem::Entry getMetadata(const std::string& path) const = 0;
-        virtual std::vector<uint8_t> getContent(const std::string& path) const = 0;
-        virtual utils::ReaderStream getStream(const std::string& path) const = 0;
+        // Non-throwing versions, intended for probing of optional files
+        // Missing files are reported without allocating anything (except for path itself in native filesystem)
+        virtual Expected<Filesystem::Entry> tryGetMetadata(const AssetId& id) const = 0;
+        virtual Expected<std::vector<uint8_t>> tryGetContent(const AssetId& id) const = 0;
+
+        // Same as try functions above, but errors are thrown as FilesystemException
+        Filesystem::Entry getMetadata(const AssetId& id) const;
+        std::vector<uint8_t> getContent(const AssetId& id) const;
+        virtual utils::ReaderStream getStream(const AssetId& id) const = 0;
+        // Same as getContent, but result can be shared without copying
+        // Implementations might alias their own memory instead of allocating new one, in this case filesystem will be kept alive by buffer
+        virtual ByteBufferPtr getBuffer(const AssetId& id) const;
 
         const std::string basePath;
     };
@@ -72,11 +85,11 @@ namespace coffee {
     public:
         ~NativeFilesystem() noexcept = default;
 
-        bool contains(const std::string& path) const noexcept override;
+        bool contains(const AssetId& id) const noexcept override;
 
-        Filesystem::Entry getMetadata(const std::string& path) const override;
-        std::vector<uint8_t> getContent(const std::string& path) const override;
-        utils::ReaderStream getStream(const std::string& path) const override;
+        Expected<Filesystem::Entry> tryGetMetadata(const AssetId& id) const override;
+        Expected<std::vector<uint8_t>> tryGetContent(const AssetId& id) const override;
+        utils::ReaderStream getStream(const AssetId& id) const override;
 
     private:
         NativeFilesystem(const std::string& path);
@@ -88,11 +101,12 @@ namespace coffee {
     public:
         ~VirtualFilesystem() noexcept;
 
-        bool contains(const std::string& path) const noexcept override;
+        bool contains(const AssetId& id) const noexcept override;
 
-        Filesystem::Entry getMetadata(const std::string& path) const override;
-        std::vector<uint8_t> getContent(const std::string& path) const override;
-        utils::ReaderStream getStream(const std::string& path) const override;
+        Expected<Filesystem::Entry> tryGetMetadata(const AssetId& id) const override;
+        Expected<std::vector<uint8_t>> tryGetContent(const AssetId& id) const override;
+        utils::ReaderStream getStream(const AssetId& id) const override;
+        ByteBufferPtr getBuffer(const AssetId& id) const override;
 
     private:
         struct InternalEntry {
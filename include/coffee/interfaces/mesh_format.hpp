@@ -0,0 +1,99 @@
+#ifndef COFFEE_INTERFACES_MESH_FORMAT
+#define COFFEE_INTERFACES_MESH_FORMAT
+
+#include <coffee/graphics/materials.hpp>
+#include <coffee/graphics/meshlet.hpp>
+#include <coffee/graphics/submesh_lod.hpp>
+#include <coffee/graphics/vertex.hpp>
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace coffee {
+
+    // CPU side content of mesh file, used for legacy files and by tools that are producing mesh files
+    struct MeshData {
+        static constexpr size_t kAmountOfTextures = 7ULL;
+
+        struct SubMesh {
+            glm::vec3 aabbMin {};
+            glm::vec3 aabbMax {};
+            graphics::Materials::Modifiers modifiers {};
+            // Paths are in order of TextureType bits (Diffuse, Specular, Normals, Emissive, Roughness, Metallic, AmbientOcclusion)
+            // Empty path means that submesh doesn't use this texture
+            std::array<std::string, kAmountOfTextures> textures {};
+            // Offsets are relative to beginning of mesh vertices and indices, indices are relative to verticesOffset
+            uint32_t verticesOffset = 0U;
+            uint32_t verticesCount = 0U;
+            uint32_t indicesOffset = 0U;
+            uint32_t indicesCount = 0U;
+            // Range inside meshlets, both are zero if meshlets weren't built for this mesh
+            uint32_t meshletsOffset = 0U;
+            uint32_t meshletsCount = 0U;
+            // Indices of LODs are stored after indices of every submesh
+            std::vector<graphics::SubMeshLod> lods {};
+        };
+
+        std::vector<SubMesh> subMeshes {};
+        std::vector<graphics::Vertex> vertices {};
+        std::vector<uint32_t> indices {};
+        std::vector<graphics::Meshlet> meshlets {};
+    };
+
+    // Same as MeshData, but geometry isn't copied and points into memory of source instead
+    // Meshlets are much smaller than geometry and usually needed on CPU side, so they're copied
+    struct MeshView {
+        std::vector<MeshData::SubMesh> subMeshes {};
+        std::vector<graphics::Meshlet> meshlets {};
+        const uint8_t* vertices = nullptr;
+        size_t verticesSize = 0ULL;
+        const uint8_t* indices = nullptr;
+        size_t indicesSize = 0ULL;
+        // Either 2 or 4 bytes, MeshData always stores 32-bit indices
+        uint32_t indexSize = sizeof(uint32_t);
+    };
+
+    // Reader and writer of .cfa files, both versions are stored in little endian
+    // Version 1 is sequence of submeshes with interleaved materials and geometry, so it must be parsed entirely
+    // Version 2 consists of fixed header, table of sections, submesh table, single vertex and index regions, optional meshlets and LODs
+    // Regions are aligned to kRegionAlignment, so they can be copied into staging memory as is or used directly from mapped archive
+    class MeshFormat {
+    public:
+        static constexpr uint32_t kLatestVersion = 2U;
+        // Covers alignment requirements of buffer copies, non-coherent memory and storage buffer offsets on every known device
+        static constexpr size_t kRegionAlignment = 256ULL;
+
+        // Returns zero if provided bytes aren't mesh file
+        static uint32_t version(const uint8_t* data, size_t size) noexcept;
+
+        // Accepts any version of file
+        static MeshData read(const uint8_t* data, size_t size);
+        // Accepts only latest version, provided bytes must outlive result
+        static MeshView view(const uint8_t* data, size_t size);
+        // Provided mesh must outlive result
+        static MeshView view(const MeshData& mesh);
+        // Always writes latest version, indices are stored as 16-bit if fitsShortIndices() allows it
+        static std::vector<uint8_t> write(const MeshData& mesh);
+
+        // Indices are relative to submesh, so 16-bit indices are enough when every submesh is small enough
+        // Last 16-bit value is excluded, so it's never confused with primitive restart
+        static bool fitsShortIndices(const std::vector<MeshData::SubMesh>& subMeshes) noexcept;
+        // Converts indices into requested size if needed, destination must have room for every index of provided mesh
+        static void copyIndices(const MeshView& mesh, uint8_t* destination, uint32_t indexSize) noexcept;
+        // Converts vertices into requested format, destination must have room for every vertex with graphics::vertexStride()
+        // Compact positions are quantized relative to AABB of submesh, so vertices outside of every submesh are left untouched
+        static void copyVertices(const MeshView& mesh, uint8_t* destination, graphics::VertexFormat format) noexcept;
+        // Same as copyVertices(), but only positions are written with graphics::positionStride()
+        static void copyPositions(const MeshView& mesh, uint8_t* destination, graphics::VertexFormat format) noexcept;
+
+        // Converts file of any version into latest one, intended to be used by asset packer
+        static inline std::vector<uint8_t> upgrade(const uint8_t* data, size_t size) { return write(read(data, size)); }
+    };
+
+} // namespace coffee
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef COFFEE_INTERFACES_MESH_OPTIMIZER
+#define COFFEE_INTERFACES_MESH_OPTIMIZER
+
+#include <coffee/interfaces/mesh_format.hpp>
+
+namespace coffee {
+
+    // Processing of mesh geometry that is intended to be done once by asset packer, but can be also requested at load time
+    // Every function works in place and keeps submesh ranges valid
+    class MeshOptimizer {
+    public:
+        // Same limits as commonly used by mesh shaders, so meshlets stay usable if renderer ever switches to them
+        static constexpr uint32_t kMaxMeshletVertices = 64U;
+        static constexpr uint32_t kMaxMeshletTriangles = 124U;
+
+        // Splits every indexed submesh into meshlets with bounding sphere and normal cone, existing meshlets are replaced
+        // Triangles inside each submesh are reordered, so every meshlet becomes contiguous range of indices
+        static void buildMeshlets(MeshData& mesh);
+
+        // Size of LRU cache that is assumed when ordering triangles, modern GPUs aren't using fixed cache anymore,
+        // but they're processing vertices in batches of similar size, so same ordering is still beneficial
+        static constexpr uint32_t kVertexCacheSize = 32U;
+
+        // Average cache miss ratio, amount of transformed vertices per triangle with simulated FIFO cache of provided size
+        // Lower is better, regular grids are approaching 0.5 and 3.0 means that cache isn't used at all
+        static float computeAcmr(const MeshData& mesh, uint32_t cacheSize = 16U);
+
+        // Reorders triangles for post-transform cache efficiency using Forsyth's algorithm
+        // Submeshes with meshlets are reordered per meshlet, so meshlets stay valid
+        static void optimizeVertexCache(MeshData& mesh);
+
+        // Reorders clusters of triangles, so clusters that are facing outwards of mesh are drawn first and occlude the rest
+        // Must be called after optimizeVertexCache(), because clusters are split where cache order already has hard boundaries
+        // Submeshes with meshlets are using them as clusters instead
+        static void optimizeOverdraw(MeshData& mesh);
+
+        // Reorders vertices inside each submesh in order of first use, so vertex fetch is mostly sequential
+        // Must be called last, after every function that reorders triangles
+        static void optimizeVertexFetch(MeshData& mesh);
+
+        // Amount of triangles in each next LOD relative to previous one
+        static constexpr float kLodReduction = 0.5f;
+
+        // Generates up to provided amount of LODs for every indexed submesh with quadric error metric, existing LODs are replaced
+        // LODs are reusing vertices of submesh, so only indices are appended, and they must be generated before optimizeVertexCache()
+        // Borders and attribute seams are preserved, so chain ends early for submeshes that cannot be reduced further
+        static void generateLods(MeshData& mesh, uint32_t amountOfLods);
+    };
+
+} // namespace coffee
+
+#endif
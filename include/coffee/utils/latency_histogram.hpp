@@ -0,0 +1,59 @@
+#ifndef COFFEE_UTILS_LATENCY_HISTOGRAM
+#define COFFEE_UTILS_LATENCY_HISTOGRAM
+
+#include <coffee/utils/non_moveable.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace coffee {
+
+    // Lock-free histogram of durations, cheap enough to be recorded from any thread at any time
+    // Buckets are logarithmic with 4 linear sub-buckets per power of two, so percentiles are accurate within 25%
+    class LatencyHistogram : NonMoveable {
+    public:
+        struct Summary {
+            uint64_t samples = 0ULL;
+            uint64_t totalMicroseconds = 0ULL;
+            uint64_t maxMicroseconds = 0ULL;
+            // Upper bound of bucket where percentile falls into
+            uint64_t p50Microseconds = 0ULL;
+            uint64_t p99Microseconds = 0ULL;
+        };
+
+        LatencyHistogram() noexcept = default;
+        ~LatencyHistogram() noexcept = default;
+
+        void record(std::chrono::steady_clock::duration duration) noexcept;
+        // Might be slightly inconsistent if values are recorded at the same time, but never blocks recording threads
+        Summary summary() const noexcept;
+
+    private:
+        static constexpr uint32_t kSubBuckets = 4U;
+        static constexpr uint32_t kAmountOfBuckets = kSubBuckets * 31U;
+
+        static uint32_t bucketIndex(uint32_t microseconds) noexcept;
+        static uint64_t bucketUpperBound(uint32_t index) noexcept;
+
+        std::array<std::atomic<uint64_t>, kAmountOfBuckets> buckets_ {};
+        std::atomic<uint64_t> totalMicroseconds_ { 0ULL };
+        std::atomic<uint64_t> maxMicroseconds_ { 0ULL };
+    };
+
+    // Records time between construction and destruction into histogram
+    class ScopedLatency : NonMoveable {
+    public:
+        inline ScopedLatency(LatencyHistogram& histogram) noexcept : histogram_ { histogram } {}
+
+        inline ~ScopedLatency() noexcept { histogram_.record(std::chrono::steady_clock::now() - start_); }
+
+    private:
+        LatencyHistogram& histogram_;
+        const std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    };
+
+} // namespace coffee
+
+#endif
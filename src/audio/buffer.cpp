@@ -0,0 +1,109 @@
+#include <coffee/audio/buffer.hpp>
+
+#include <coffee/audio/exceptions.hpp>
+#include <coffee/utils/log.hpp>
+
+#include <AL/alc.h>
+
+#include <limits>
+#include <utility>
+
+namespace coffee { namespace audio {
+
+    Buffer::Buffer()
+    {
+        validate();
+
+        alGenBuffers(1, &bufferHandle_);
+
+        if (alGetError() != AL_NO_ERROR) {
+            throw AudioException { AudioException::Type::OutOfMemory, "Ran out of memory" };
+        }
+    }
+
+    Buffer::Buffer(ALuint handle) noexcept : bufferHandle_ { handle } {}
+
+    Buffer::~Buffer() noexcept
+    {
+        if (bufferHandle_ != AL_INVALID) {
+            alDeleteBuffers(1, &bufferHandle_);
+        }
+    }
+
+    Buffer::Buffer(Buffer&& other) noexcept
+        : bufferHandle_ { std::exchange(other.bufferHandle_, AL_INVALID) }
+        , format_ { std::exchange(other.format_, AudioFormat::None) }
+        , frequency_ { std::exchange(other.frequency_, 0U) }
+        , size_ { std::exchange(other.size_, 0ULL) }
+    {}
+
+    Buffer& Buffer::operator=(Buffer&& other) noexcept
+    {
+        if (this == &other) {
+            return *this;
+        }
+
+        if (bufferHandle_ != AL_INVALID) {
+            alDeleteBuffers(1, &bufferHandle_);
+        }
+
+        bufferHandle_ = std::exchange(other.bufferHandle_, AL_INVALID);
+        format_ = std::exchange(other.format_, AudioFormat::None);
+        frequency_ = std::exchange(other.frequency_, 0U);
+        size_ = std::exchange(other.size_, 0ULL);
+
+        return *this;
+    }
+
+    Buffer Buffer::create() { return Buffer {}; }
+
+    std::vector<Buffer> Buffer::create(uint32_t size)
+    {
+        validate();
+
+        std::vector<ALuint> handles {};
+        handles.resize(size);
+        alGenBuffers(static_cast<ALsizei>(size), handles.data());
+
+        if (alGetError() != AL_NO_ERROR) {
+            throw AudioException { AudioException::Type::OutOfMemory, "Ran out of memory" };
+        }
+
+        std::vector<Buffer> buffers {};
+        buffers.reserve(size);
+
+        for (ALuint handle : handles) {
+            buffers.push_back(Buffer { handle });
+        }
+
+        return buffers;
+    }
+
+    void Buffer::upload(AudioFormat format, const void* data, size_t size, uint32_t frequency)
+    {
+        COFFEE_ASSERT(format != AudioFormat::None, "Invalid audio format provided.");
+        COFFEE_ASSERT(size <= static_cast<size_t>(std::numeric_limits<ALsizei>::max()), "OpenAL buffer must be less than 2GB.");
+
+        validate();
+
+        alBufferData(bufferHandle_, static_cast<ALenum>(format), data, static_cast<ALsizei>(size), static_cast<ALsizei>(frequency));
+
+        if (alGetError() != AL_NO_ERROR) {
+            throw AudioException { AudioException::Type::OutOfMemory, "Failed to upload data into buffer" };
+        }
+
+        format_ = format;
+        frequency_ = frequency;
+        size_ = size;
+    }
+
+    void Buffer::validate()
+    {
+        if (alcGetCurrentContext() == nullptr) {
+            throw AudioException { AudioException::Type::ContextFailure, "No context was bound" };
+        }
+
+        alGetError();
+    }
+
+}} // namespace coffee::audio
@@ -58,6 +58,13 @@ namespace coffee { namespace audio {
 
     Source Source::create() { return Source {}; }
 
+    void Source::setBuffer(const Buffer& buffer)
+    {
+        validate();
+
+        alSourcei(sourceHandle_, AL_BUFFER, static_cast<ALint>(buffer.handle()));
+    }
+
     void Source::play()
     {
         validate();
@@ -1,5 +1,8 @@
 #include <coffee/graphics/aabb.hpp>
 
+#include <algorithm>
+#include <limits>
+
 namespace coffee { namespace graphics {
 
     AABBPoints AABB::transform(const glm::mat4& meshMatrix) const noexcept
@@ -22,4 +25,30 @@ namespace coffee { namespace graphics {
         return aabbPoints;
     }
 
+    float AABB::projectedSize(const glm::mat4& modelViewProjection) const noexcept
+    {
+        AABBPoints aabbPoints = transform(modelViewProjection);
+
+        float minX = std::numeric_limits<float>::max();
+        float minY = std::numeric_limits<float>::max();
+        float maxX = std::numeric_limits<float>::lowest();
+        float maxY = std::numeric_limits<float>::lowest();
+
+        for (size_t i = 0; i < AABBPoints::kAmountOfPoints; i++) {
+            const glm::vec4& point = aabbPoints[i];
+
+            if (point.w <= 0.0f) {
+                return 1.0f;
+            }
+
+            minX = std::min(minX, point.x / point.w);
+            minY = std::min(minY, point.y / point.w);
+            maxX = std::max(maxX, point.x / point.w);
+            maxY = std::max(maxY, point.y / point.w);
+        }
+
+        // Normalized device coordinates are spanning [-1, 1], so half of extent is fraction of screen
+        return std::max(maxX - minX, maxY - minY) * 0.5f;
+    }
+
 }} // namespace coffee::graphics
\ No newline at end of file
@@ -4,12 +4,25 @@
 
 namespace coffee { namespace graphics {
 
-    Mesh::Mesh(std::vector<SubMesh>&& subMeshes, BufferPtr&& verticesBuffer, BufferPtr&& indicesBuffer)
+    Mesh::Mesh(
+        std::vector<SubMesh>&& subMeshes,
+        BufferPtr&& verticesBuffer,
+        BufferPtr&& indicesBuffer,
+        VkIndexType indexType,
+        std::vector<Meshlet>&& meshlets,
+        VertexFormat vertexFormat,
+        BufferPtr&& positionsBuffer
+    )
         : subMeshes { std::move(subMeshes) }
         , verticesBuffer { std::move(verticesBuffer) }
         , indicesBuffer { std::move(indicesBuffer) }
+        , indexType { indexType }
+        , meshlets { std::move(meshlets) }
+        , vertexFormat { vertexFormat }
+        , positionsBuffer { std::move(positionsBuffer) }
     {
         COFFEE_ASSERT(this->verticesBuffer != nullptr, "Invalid vertices buffer provided.");
+        COFFEE_ASSERT(indexType == VK_INDEX_TYPE_UINT16 || indexType == VK_INDEX_TYPE_UINT32, "Unsupported index type provided.");
     }
 
 }} // namespace coffee::graphics
\ No newline at end of file
@@ -0,0 +1,241 @@
+#include <coffee/graphics/staging_ring.hpp>
+
+#include <coffee/graphics/command_buffer.hpp>
+#include <coffee/graphics/device.hpp>
+#include <coffee/utils/log.hpp>
+#include <coffee/utils/math.hpp>
+
+#include <algorithm>
+
+namespace coffee { namespace graphics {
+
+    namespace detail {
+
+        constexpr uint64_t alignOffset(uint64_t offset, uint64_t alignment) noexcept { return (offset + alignment - 1) & ~(alignment - 1); }
+
+        BufferConfiguration stagingConfiguration(size_t size)
+        {
+            COFFEE_ASSERT(size <= std::numeric_limits<uint32_t>::max(), "Staging allocation must be less than 4GB.");
+
+            BufferConfiguration configuration {};
+            configuration.instanceSize = 1U;
+            configuration.instanceCount = static_cast<uint32_t>(size);
+            configuration.usageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+            configuration.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+            configuration.allocationFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            configuration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+            return configuration;
+        }
+
+    } // namespace detail
+
+    StagingRegion::StagingRegion(StagingRing* ring, uint64_t recordIndex, BufferPtr buffer, VkDeviceSize offset, VkDeviceSize size, uint8_t* memory)
+        : buffer { std::move(buffer) }
+        , offset { offset }
+        , size { size }
+        , memory { memory }
+        , ring_ { ring }
+        , recordIndex_ { recordIndex }
+    {}
+
+    StagingRegion::StagingRegion(StagingRegion&& other) noexcept
+        : buffer { other.buffer }
+        , offset { other.offset }
+        , size { other.size }
+        , memory { other.memory }
+        , ring_ { std::exchange(other.ring_, nullptr) }
+        , recordIndex_ { other.recordIndex_ }
+        , fence_ { std::move(other.fence_) }
+        , keepAlive_ { std::move(other.keepAlive_) }
+        , submitTime_ { other.submitTime_ }
+        , submitted_ { other.submitted_ }
+    {}
+
+    StagingRegion::~StagingRegion() noexcept
+    {
+        if (ring_ != nullptr) {
+            ring_->release(*this);
+        }
+    }
+
+    void StagingRegion::flush() { buffer->flush(size, offset); }
+
+    void StagingRegion::keepAlive(std::shared_ptr<void> object) { keepAlive_.push_back(std::move(object)); }
+
+    void StagingRegion::submit(CommandBuffer&& commandBuffer, const SubmitSemaphores& semaphores)
+    {
+        COFFEE_ASSERT(!submitted_, "Staging region must be submitted only once.");
+
+        ring_->device_->submit(std::move(commandBuffer), semaphores, fence_);
+        submitTime_ = std::chrono::steady_clock::now();
+        submitted_ = true;
+    }
+
+    StagingRing::StagingRing(const DevicePtr& device, const StagingRingConfiguration& configuration)
+        : device_ { device }
+        , capacity_ { configuration.size }
+        , dedicatedThreshold_ { configuration.dedicatedThreshold == 0 ? configuration.size / 2 : configuration.dedicatedThreshold }
+        , minimalAlignment_ { std::max<size_t>(device->properties().limits.optimalBufferCopyOffsetAlignment, 16ULL) }
+    {
+        COFFEE_ASSERT(capacity_ > 0, "Staging ring cannot be allocated with size 0.");
+
+        buffer_ = Buffer::create(device_, detail::stagingConfiguration(capacity_));
+        memory_ = static_cast<uint8_t*>(buffer_->memory());
+    }
+
+    StagingRing::~StagingRing() noexcept
+    {
+        tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+        for (auto& record : records_) {
+            COFFEE_ASSERT(record.released, "Staging region outlived it's ring.");
+
+            if (record.fence != nullptr) {
+                record.fence->wait();
+            }
+        }
+
+        reclaimUnsafe();
+    }
+
+    StagingRingPtr StagingRing::create(const DevicePtr& device, const StagingRingConfiguration& configuration)
+    {
+        COFFEE_ASSERT(device != nullptr, "Invalid device provided.");
+
+        return std::shared_ptr<StagingRing>(new StagingRing { device, configuration });
+    }
+
+    StagingRegion StagingRing::allocate(size_t size, size_t alignment)
+    {
+        COFFEE_ASSERT(size > 0, "Staging region cannot be allocated with size 0.");
+        COFFEE_ASSERT(Math::hasSingleBit(alignment), "Alignment must be power of 2.");
+
+        if (size > dedicatedThreshold_) {
+            return allocateDedicated(size);
+        }
+
+        alignment = std::max(alignment, minimalAlignment_);
+
+        tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+        for (uint32_t attempt = 0; attempt < 2; attempt++) {
+            uint64_t physicalOffset = head_ % capacity_;
+            uint64_t alignedOffset = detail::alignOffset(physicalOffset, alignment);
+
+            // Requests never wraps around, instead tail of ring is skipped and accounted as part of this region
+            if (alignedOffset + size > capacity_) {
+                alignedOffset = capacity_;
+            }
+
+            uint64_t end = head_ + (alignedOffset - physicalOffset) + size;
+            alignedOffset %= capacity_;
+
+            if (end - tail_ <= capacity_) {
+                FencePtr fence = acquireFence();
+                uint64_t recordIndex = pushRecord(end, nullptr);
+                head_ = end;
+
+                StagingRegion region { this, recordIndex, buffer_, alignedOffset, size, memory_ + alignedOffset };
+                region.fence_ = std::move(fence);
+                return region;
+            }
+
+            reclaimUnsafe();
+        }
+
+        lock.release();
+
+        // Ring is fully occupied by in-flight uploads, instead of stalling calling thread we just use separate allocation
+        return allocateDedicated(size);
+    }
+
+    void StagingRing::reclaim()
+    {
+        tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+        reclaimUnsafe();
+    }
+
+    StagingRegion StagingRing::allocateDedicated(size_t size)
+    {
+        BufferPtr dedicatedBuffer = Buffer::create(device_, detail::stagingConfiguration(size));
+        uint8_t* memory = static_cast<uint8_t*>(dedicatedBuffer->memory());
+
+        tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+        FencePtr fence = acquireFence();
+        uint64_t recordIndex = pushRecord(head_, dedicatedBuffer);
+
+        StagingRegion region { this, recordIndex, std::move(dedicatedBuffer), 0ULL, size, memory };
+        region.fence_ = std::move(fence);
+        return region;
+    }
+
+    uint64_t StagingRing::pushRecord(uint64_t end, BufferPtr dedicatedBuffer)
+    {
+        Record record {};
+        record.end = end;
+        record.dedicatedBuffer = std::move(dedicatedBuffer);
+        records_.push_back(std::move(record));
+
+        return firstRecordIndex_ + records_.size() - 1;
+    }
+
+    FencePtr StagingRing::acquireFence()
+    {
+        if (freeFences_.empty()) {
+            return Fence::create(device_);
+        }
+
+        FencePtr fence = std::move(freeFences_.back());
+        freeFences_.pop_back();
+        return fence;
+    }
+
+    void StagingRing::release(StagingRegion& region) noexcept
+    {
+        tbb::queuing_mutex::scoped_lock lock { mutex_ };
+
+        Record& record = records_[region.recordIndex_ - firstRecordIndex_];
+        record.released = true;
+        record.keepAlive = std::move(region.keepAlive_);
+
+        if (region.submitted_) {
+            record.fence = std::move(region.fence_);
+            record.submitTime = region.submitTime_;
+        }
+        else {
+            // Fence was never submitted so it's still unsignaled and can be given to next region as is
+            freeFences_.push_back(std::move(region.fence_));
+        }
+
+        reclaimUnsafe();
+    }
+
+    void StagingRing::reclaimUnsafe() noexcept
+    {
+        while (!records_.empty()) {
+            Record& record = records_.front();
+
+            if (!record.released) {
+                break;
+            }
+
+            if (record.fence != nullptr) {
+                if (record.fence->status() != VK_SUCCESS) {
+                    break;
+                }
+
+                completionLatency_.record(std::chrono::steady_clock::now() - record.submitTime);
+
+                record.fence->reset();
+                freeFences_.push_back(std::move(record.fence));
+            }
+
+            tail_ = record.end;
+            records_.pop_front();
+            firstRecordIndex_++;
+        }
+    }
+
+}} // namespace coffee::graphics
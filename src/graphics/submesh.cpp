@@ -4,13 +4,43 @@
 
 namespace coffee { namespace graphics {
 
-    SubMesh::SubMesh(Materials&& mats, AABB&& aabb, uint32_t vertsOffset, uint32_t indsOffset, uint32_t vertsCount, uint32_t indsCount)
+    SubMesh::SubMesh(
+        Materials&& mats,
+        AABB&& aabb,
+        uint32_t vertsOffset,
+        uint32_t indsOffset,
+        uint32_t vertsCount,
+        uint32_t indsCount,
+        uint32_t meshletsOffset,
+        uint32_t meshletsCount,
+        std::vector<SubMeshLod>&& lods
+    )
         : materials { std::move(mats) }
         , aabb { std::move(aabb) }
         , verticesOffset { vertsOffset }
         , indicesOffset { indsOffset }
         , verticesCount { vertsCount }
         , indicesCount { indsCount }
+        , meshletsOffset { meshletsOffset }
+        , meshletsCount { meshletsCount }
+        , lods { std::move(lods) }
     {}
 
+    uint32_t SubMesh::selectLod(float projectedSize, float screenHeight, float maxPixelError) const noexcept
+    {
+        const float sizeInPixels = projectedSize * screenHeight;
+        uint32_t result = 0U;
+
+        // Errors are growing with each level, so first LOD that is too coarse ends the search
+        for (const SubMeshLod& lod : lods) {
+            if (lod.error * sizeInPixels > maxPixelError) {
+                break;
+            }
+
+            result++;
+        }
+
+        return result;
+    }
+
 }} // namespace coffee::graphics
\ No newline at end of file
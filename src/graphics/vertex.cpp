@@ -9,6 +9,68 @@ namespace coffee { namespace graphics {
 
     bool Vertex::operator!=(const Vertex& other) { return !operator==(other); }
 
+    namespace detail {
+
+        // Normals and tangents are stored as 16-bit SNORM, so they're read through signed integers
+        glm::vec3 decodeSnorm(const glm::u16vec3& value) noexcept
+        {
+            return glm::max(glm::vec3 { glm::i16vec3 { value } } / 32767.0f, glm::vec3 { -1.0f });
+        }
+
+        // Unit vector is projected onto octahedron, lower half of which is folded over upper one
+        glm::i16vec2 encodeOctahedral(const glm::vec3& vector) noexcept
+        {
+            float length = glm::abs(vector.x) + glm::abs(vector.y) + glm::abs(vector.z);
+
+            if (length <= 0.0f) {
+                return {};
+            }
+
+            glm::vec2 result = glm::vec2 { vector } / length;
+
+            if (vector.z < 0.0f) {
+                glm::vec2 sign { result.x >= 0.0f ? 1.0f : -1.0f, result.y >= 0.0f ? 1.0f : -1.0f };
+                result = (1.0f - glm::abs(glm::vec2 { result.y, result.x })) * sign;
+            }
+
+            return glm::i16vec2 { glm::round(glm::clamp(result, -1.0f, 1.0f) * 32767.0f) };
+        }
+
+        glm::u16vec4 quantizePosition(const glm::vec3& position, const glm::vec3& aabbMin, const glm::vec3& aabbMax) noexcept
+        {
+            glm::vec3 extent = aabbMax - aabbMin;
+            glm::vec3 normalized {};
+
+            // Flat submeshes are quantized into zero on their flat axis
+            for (glm::length_t axis = 0; axis < 3; axis++) {
+                normalized[axis] = extent[axis] > 0.0f ? glm::clamp((position[axis] - aabbMin[axis]) / extent[axis], 0.0f, 1.0f) : 0.0f;
+            }
+
+            return glm::u16vec4 { glm::u16vec3 { glm::round(normalized * 65535.0f) }, 65535U };
+        }
+
+    } // namespace detail
+
+    CompactVertex CompactVertex::encode(const Vertex& vertex, const glm::vec3& aabbMin, const glm::vec3& aabbMax) noexcept
+    {
+        CompactVertex result {};
+        result.position = detail::quantizePosition(vertex.position, aabbMin, aabbMax);
+        result.normal = detail::encodeOctahedral(detail::decodeSnorm(vertex.normal));
+        result.tangent = detail::encodeOctahedral(detail::decodeSnorm(vertex.tangent));
+        result.texCoords = vertex.texCoords;
+        return result;
+    }
+
+    PositionVertex PositionVertex::encode(const Vertex& vertex, const glm::vec3&, const glm::vec3&) noexcept
+    {
+        return { vertex.position };
+    }
+
+    CompactPositionVertex CompactPositionVertex::encode(const Vertex& vertex, const glm::vec3& aabbMin, const glm::vec3& aabbMax) noexcept
+    {
+        return { detail::quantizePosition(vertex.position, aabbMin, aabbMax) };
+    }
+
 }} // namespace coffee::graphics
 
 namespace std {
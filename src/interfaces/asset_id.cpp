@@ -0,0 +1,34 @@
+#include <coffee/interfaces/asset_id.hpp>
+
+#include <oneapi/tbb/concurrent_unordered_map.h>
+#include <xxh3/xxhash.h>
+
+namespace coffee {
+
+    namespace detail {
+
+        // Nodes are never moved or erased, so views into stored strings stay valid forever
+        static tbb::concurrent_unordered_map<XXH64_hash_t, std::string>& internedPaths()
+        {
+            static tbb::concurrent_unordered_map<XXH64_hash_t, std::string> paths {};
+            return paths;
+        }
+
+    } // namespace detail
+
+    AssetId::AssetId(const std::string& path) noexcept : hash_ { XXH3_64bits(path.data(), path.size()) }, path_ { path } {}
+
+    AssetId AssetId::intern(std::string_view path)
+    {
+        auto& paths = detail::internedPaths();
+        XXH64_hash_t hash = XXH3_64bits(path.data(), path.size());
+
+        if (auto it = paths.find(hash); it != paths.end()) {
+            return AssetId { hash, it->second };
+        }
+
+        auto it = paths.emplace(hash, std::string { path }).first;
+        return AssetId { hash, it->second };
+    }
+
+} // namespace coffee
@@ -1,13 +1,35 @@
 #include <coffee/interfaces/asset_manager.hpp>
 
 #include <coffee/graphics/command_buffer.hpp>
+#include <coffee/graphics/semaphore.hpp>
 #include <coffee/graphics/vertex.hpp>
 #include <coffee/interfaces/exceptions.hpp>
+#include <coffee/interfaces/mesh_optimizer.hpp>
+#include <coffee/utils/math.hpp>
 #include <coffee/utils/utils.hpp>
 
 #include <basis_universal/basisu_transcoder.h>
+#include <oneapi/tbb/enumerable_thread_specific.h>
 #include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/parallel_pipeline.h>
+#include <oneapi/tbb/task_arena.h>
+#include <oneapi/tbb/task_group.h>
 #include <xxh3/xxhash.h>
+#include <zstd/zstd.h>
+
+#define STB_VORBIS_HEADER_ONLY
+#include <stb_vorbis/stb_vorbis.c>
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <optional>
+#include <random>
 
 namespace coffee {
 
@@ -53,9 +75,138 @@ namespace coffee {
             }
         }
 
+        // Images and meshes are loaded by separate read, decode and upload steps, everything else is loaded as a whole
+        constexpr bool isStagedType(Filesystem::FileType type) noexcept
+        {
+            return type == Filesystem::FileType::RawImage || type == Filesystem::FileType::BasisImage || type == Filesystem::FileType::Mesh;
+        }
+
+        constexpr AssetError exceptionTypeToError(FilesystemException::Type type) noexcept
+        {
+            switch (type) {
+                case FilesystemException::Type::FileNotFound:
+                    return AssetError::FileNotFound;
+                case FilesystemException::Type::InvalidFileType:
+                    return AssetError::InvalidFileType;
+                case FilesystemException::Type::InvalidFilesystemSignature:
+                    return AssetError::InvalidFilesystem;
+                case FilesystemException::Type::DecompressionFailure:
+                    return AssetError::DecompressionFailure;
+                default:
+                    return AssetError::ImplementationFailure;
+            }
+        }
+
+        constexpr AssetError exceptionTypeToError(AssetException::Type type) noexcept
+        {
+            switch (type) {
+                case AssetException::Type::TypeMismatch:
+                    return AssetError::TypeMismatch;
+                case AssetException::Type::NotInCache:
+                    return AssetError::NotInCache;
+                case AssetException::Type::InvalidFilesystem:
+                    return AssetError::InvalidFilesystem;
+                case AssetException::Type::InvalidRequest:
+                    return AssetError::InvalidRequest;
+                default:
+                    return AssetError::ImplementationFailure;
+            }
+        }
+
+        constexpr uint32_t kTranscodeCacheMagic = 0x43544643; // CFTC
+        constexpr int kTranscodeCacheCompressionLevel = 3;
+
+        // Transcode cache is local to this machine, so it's written in native endianness
+        struct TranscodeCacheHeader {
+            uint32_t magic = 0;
+            uint32_t transcoderVersion = 0;
+            uint64_t contentHash = 0;
+            uint32_t format = 0;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t mipLevels = 0;
+            uint32_t arrayLayers = 0;
+            uint32_t amountOfRegions = 0;
+            uint64_t uncompressedSize = 0;
+            uint64_t compressedSize = 0;
+        };
+
+        struct TranscodeCacheRegion {
+            uint64_t bufferOffset = 0;
+            uint32_t mipLevel = 0;
+            uint32_t faceIndex = 0;
+            uint32_t width = 0;
+            uint32_t height = 0;
+        };
+
+        struct WaveFormat {
+            uint16_t formatTag = 0;
+            uint16_t channels = 0;
+            uint32_t sampleRate = 0;
+            uint16_t bitsPerSample = 0;
+        };
+
+        constexpr uint16_t kWaveFormatPCM = 0x0001;
+        constexpr uint16_t kWaveFormatIEEEFloat = 0x0003;
+        constexpr uint16_t kWaveFormatExtensible = 0xFFFE;
+
+        template <typename T>
+        [[nodiscard]] inline T readLittleEndian(const uint8_t* data)
+        {
+            T result {};
+            std::memcpy(&result, data, sizeof(result));
+
+            if (!Math::isSystemLittleEndian()) {
+                result = Math::byteSwap(result);
+            }
+
+            return result;
+        }
+
+        // Converts samples that OpenAL cannot consume directly into signed 16-bit ones
+        std::vector<uint8_t> convertToPCM16(const WaveFormat& format, const uint8_t* samples, size_t size)
+        {
+            const size_t bytesPerSample = format.bitsPerSample / 8U;
+            const size_t amountOfSamples = size / bytesPerSample;
+
+            std::vector<uint8_t> converted {};
+            converted.resize(amountOfSamples * sizeof(int16_t));
+
+            for (size_t index = 0; index < amountOfSamples; index++) {
+                const uint8_t* sample = samples + index * bytesPerSample;
+                int16_t value = 0;
+
+                if (format.formatTag == kWaveFormatIEEEFloat) {
+                    uint32_t rawValue = readLittleEndian<uint32_t>(sample);
+                    float floatValue = 0.0f;
+                    std::memcpy(&floatValue, &rawValue, sizeof(floatValue));
+
+                    value = static_cast<int16_t>(std::clamp(floatValue, -1.0f, 1.0f) * 32767.0f);
+                }
+                else {
+                    // Only upper 16 bits are kept, 24-bit and 32-bit samples are stored as little endian signed integers
+                    value = static_cast<int16_t>(readLittleEndian<uint16_t>(sample + bytesPerSample - sizeof(int16_t)));
+                }
+
+                std::memcpy(converted.data() + index * sizeof(int16_t), &value, sizeof(int16_t));
+            }
+
+            return converted;
+        }
+
     } // namespace detail
 
-    AssetManager::AssetManager(const graphics::DevicePtr& device) : device_ { device }
+    AssetManager::AssetManager(const graphics::DevicePtr& device, const AssetManagerConfiguration& configuration)
+        : device_ { device }
+        , memoryBudget_ { configuration.memoryBudget }
+        , heapPressureThreshold_ { configuration.heapPressureThreshold }
+        , weakReferences_ { configuration.weakReferences }
+        , streamingBytesPerFrame_ { configuration.streamingBytesPerFrame }
+        , streamingInitialExtent_ { configuration.streamingInitialExtent }
+        , transcodeCachePath_ { configuration.transcodeCachePath }
+        , schedulerConcurrency_ { configuration.schedulerConcurrency == 0 ? static_cast<uint32_t>(tbb::this_task_arena::max_concurrency())
+                                                                          : configuration.schedulerConcurrency }
+        , stagingRing_ { graphics::StagingRing::create(device, { configuration.stagingRingSize, configuration.dedicatedStagingThreshold }) }
     {
         createMissingTexture();
 
@@ -65,72 +216,295 @@ namespace coffee {
         selectFourChannels();
     }
 
-    AssetManagerPtr AssetManager::create(const graphics::DevicePtr& device)
+    AssetManager::~AssetManager() noexcept
+    {
+        {
+            // Requests that wasn't started yet would only delay destruction
+            tbb::queuing_mutex::scoped_lock lock { schedulerMutex_ };
+
+            for (const auto& ticket : scheduledLoads_) {
+                ticket->cancel();
+            }
+        }
+
+        // Background tasks are referencing this manager, so they must be done before anything is destroyed
+        backgroundTasks_.wait();
+    }
+
+    AssetManagerPtr AssetManager::create(const graphics::DevicePtr& device, const AssetManagerConfiguration& configuration)
     {
         COFFEE_ASSERT(device != nullptr, "Invalid device provided.");
 
-        return std::shared_ptr<AssetManager>(new AssetManager { device });
+        return std::shared_ptr<AssetManager>(new AssetManager { device, configuration });
+    }
+
+    template <typename Fx>
+    AssetManager::Asset AssetManager::acquireAsset(XXH64_hash_t hash, Fx&& loadFunction)
+    {
+        Asset cachedAsset {};
+
+        if (findCachedAsset(hash, cachedAsset)) {
+            recordCacheHit(cachedAsset.type);
+            return cachedAsset;
+        }
+
+        std::promise<Asset> promise {};
+        std::shared_future<Asset> pendingLoad {};
+
+        {
+            PendingAccessor accessor {};
+
+            if (!pendingLoads_.insert(accessor, hash)) {
+                // Somebody else already loading this asset, so we just wait for it's result (or exception)
+                pendingLoad = accessor->second;
+                accessor.release();
+
+                // Waiting for somebody else's load is still a hit, because file is loaded only once
+                Asset loadedAsset = pendingLoad.get();
+                recordCacheHit(loadedAsset.type);
+                return loadedAsset;
+            }
+
+            accessor->second = promise.get_future().share();
+        }
+
+        inFlightLoads_.fetch_add(1ULL, std::memory_order_relaxed);
+
+        // Pending entry must be removed in any case, otherwise every following request will wait forever
+        ScopeGuard pendingGuard { [this, hash]() {
+            pendingLoads_.erase(hash);
+            inFlightLoads_.fetch_sub(1ULL, std::memory_order_relaxed);
+        } };
+
+        try {
+            // Load might be finished between cache lookup and pending insertion
+            if (findCachedAsset(hash, cachedAsset)) {
+                recordCacheHit(cachedAsset.type);
+                promise.set_value(cachedAsset);
+                return cachedAsset;
+            }
+
+            // Isolation prevents this thread from stealing tasks that might wait on this exact load, which will result in deadlock
+            Asset asset = tbb::this_task_arena::isolate([&]() { return loadFunction(); });
+            measureAsset(asset);
+            typeCounters_[static_cast<size_t>(asset.type)].misses.fetch_add(1ULL, std::memory_order_relaxed);
+
+            {
+                tbb::queuing_mutex::scoped_lock lock { residencyMutex_ };
+                std::shared_ptr<Residency>& residency = residency_[hash];
+
+                if (residency != nullptr) {
+                    trackResidentBytes(*residency, false);
+                }
+
+                residency = asset.residency;
+                trackResidentBytes(*residency, true);
+            }
+
+            {
+                // Entry might already exist if it was weak and it's object expired, so it must be overwritten
+                tbb::concurrent_hash_map<XXH64_hash_t, Asset>::accessor accessor {};
+                cache_.insert(accessor, hash);
+                accessor->second = asset;
+
+                if (weakReferences_) {
+                    accessor->second.weakObject = asset.actualObject;
+                    accessor->second.actualObject = nullptr;
+                }
+            }
+
+            promise.set_value(asset);
+
+            return asset;
+        }
+        catch (...) {
+            failedLoads_.fetch_add(1ULL, std::memory_order_relaxed);
+            promise.set_exception(std::current_exception());
+            throw;
+        }
     }
 
-    std::vector<uint8_t> AssetManager::loadBytes(const BytesLoadingInfo& loadingInfo)
+    bool AssetManager::findCachedAsset(XXH64_hash_t hash, Asset& asset)
     {
         HashAccessor accessor {};
-        XXH64_hash_t hash = XXH3_64bits(loadingInfo.path.data(), loadingInfo.path.size());
 
         if (!cache_.find(accessor, hash)) {
-            if (loadingInfo.filesystem == nullptr) {
-                throw AssetException { AssetException::Type::NotInCache,
-                                       fmt::format("Requested asset '{}' wasn't in cache, and filesystem wasn't provided", loadingInfo.path) };
-            }
+            return false;
+        }
+
+        asset = accessor->second;
+
+        // Weak entries doesn't hold object, so it must be restored from weak reference, expired entry must be loaded again
+        if (asset.actualObject == nullptr && (asset.actualObject = asset.weakObject.lock()) == nullptr) {
+            return false;
+        }
+
+        asset.residency->lastUsedFrame.store(currentFrame_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return true;
+    }
+
+    Filesystem::Entry AssetManager::requestMetadata(const FilesystemPtr& filesystem, const AssetId& id)
+    {
+        if (filesystem == nullptr) {
+            throw AssetException { AssetException::Type::NotInCache,
+                                   fmt::format("Requested asset '{}' wasn't in cache, and filesystem wasn't provided", id.path()) };
+        }
+
+        return filesystem->getMetadata(id);
+    }
+
+    std::vector<uint8_t> AssetManager::readContent(const FilesystemPtr& filesystem, const AssetId& id)
+    {
+        ScopedLatency latency { stageLatency(AssetStatistics::Stage::Read) };
+
+        return filesystem->getContent(id);
+    }
+
+    ByteBufferPtr AssetManager::readBuffer(const FilesystemPtr& filesystem, const AssetId& id)
+    {
+        ScopedLatency latency { stageLatency(AssetStatistics::Stage::Read) };
+
+        return filesystem->getBuffer(id);
+    }
+
+    std::optional<AssetError> AssetManager::probeAsset(
+        const FilesystemPtr& filesystem,
+        const AssetId& id,
+        Filesystem::FileType cachedType,
+        Filesystem::FileType firstType,
+        Filesystem::FileType secondType
+    )
+    {
+        Asset cachedAsset {};
+
+        if (findCachedAsset(id.hash(), cachedAsset)) {
+            return cachedAsset.type == cachedType ? std::nullopt : std::optional<AssetError> { AssetError::TypeMismatch };
+        }
+
+        if (filesystem == nullptr) {
+            return AssetError::NotInCache;
+        }
+
+        Expected<Filesystem::Entry> entry = filesystem->tryGetMetadata(id);
+
+        if (!entry) {
+            return entry.error();
+        }
+
+        if (entry->type != firstType && entry->type != secondType) {
+            return AssetError::TypeMismatch;
+        }
+
+        return std::nullopt;
+    }
+
+    template <typename Fx>
+    auto AssetManager::tryLoadAsset(std::optional<AssetError> probeResult, Fx&& loadFunction) -> Expected<decltype(loadFunction())>
+    {
+        if (probeResult.has_value()) {
+            return *probeResult;
+        }
+
+        // Only broken files and failures of implementation gets here, so exceptions are rare enough to not matter
+        try {
+            return loadFunction();
+        }
+        catch (const FilesystemException& exception) {
+            return detail::exceptionTypeToError(exception.type);
+        }
+        catch (const AssetException& exception) {
+            return detail::exceptionTypeToError(exception.type);
+        }
+        catch (const std::exception&) {
+            return AssetError::ImplementationFailure;
+        }
+    }
+
+    Expected<ByteBufferPtr> AssetManager::tryLoadBytes(const BytesLoadingInfo& loadingInfo)
+    {
+        using FileType = Filesystem::FileType;
+
+        return tryLoadAsset(probeAsset(loadingInfo.filesystem, loadingInfo.path, FileType::RawBytes, FileType::RawBytes, FileType::RawBytes), [&]() {
+            return loadBytes(loadingInfo);
+        });
+    }
+
+    Expected<graphics::ShaderPtr> AssetManager::tryLoadShader(const ShaderLoadingInfo& loadingInfo)
+    {
+        using FileType = Filesystem::FileType;
+
+        return tryLoadAsset(probeAsset(loadingInfo.filesystem, loadingInfo.path, FileType::Shader, FileType::Shader, FileType::Shader), [&]() {
+            return loadShader(loadingInfo);
+        });
+    }
+
+    Expected<graphics::ImagePtr> AssetManager::tryLoadImage(const ImageLoadingInfo& loadingInfo)
+    {
+        using FileType = Filesystem::FileType;
+
+        return tryLoadAsset(
+            probeAsset(loadingInfo.filesystem, loadingInfo.path, FileType::RawImage, FileType::RawImage, FileType::BasisImage),
+            [&]() { return loadImage(loadingInfo); }
+        );
+    }
+
+    Expected<graphics::MeshPtr> AssetManager::tryLoadMesh(const MeshLoadingInfo& loadingInfo)
+    {
+        using FileType = Filesystem::FileType;
 
-            Filesystem::Entry entry = loadingInfo.filesystem->getMetadata(loadingInfo.path);
+        return tryLoadAsset(probeAsset(loadingInfo.filesystem, loadingInfo.path, FileType::Mesh, FileType::Mesh, FileType::Mesh), [&]() {
+            return loadMesh(loadingInfo);
+        });
+    }
+
+    Expected<audio::BufferPtr> AssetManager::tryLoadSound(const SoundLoadingInfo& loadingInfo)
+    {
+        using FileType = Filesystem::FileType;
+
+        return tryLoadAsset(probeAsset(loadingInfo.filesystem, loadingInfo.path, FileType::WAV, FileType::WAV, FileType::OGG), [&]() {
+            return loadSound(loadingInfo);
+        });
+    }
+
+    ByteBufferPtr AssetManager::loadBytes(const BytesLoadingInfo& loadingInfo)
+    {
+        XXH64_hash_t hash = loadingInfo.path.hash();
+
+        Asset asset = acquireAsset(hash, [&]() {
+            Filesystem::Entry entry = requestMetadata(loadingInfo.filesystem, loadingInfo.path);
 
             if (entry.type != Filesystem::FileType::RawBytes) {
                 throw AssetException { AssetException::Type::TypeMismatch,
                                        fmt::format("Expected type Raw, requested type was {}", detail::fileTypeToString(entry.type)) };
             }
 
-            std::vector<uint8_t> rawBytes = loadingInfo.filesystem->getContent(loadingInfo.path);
-
-            cache_.insert(std::make_pair(hash, Asset::create(std::make_shared<std::vector<uint8_t>>(rawBytes))));
-        }
-
-        auto& asset = accessor->second;
+            return Asset::create(readBuffer(loadingInfo.filesystem, loadingInfo.path));
+        });
 
         if (asset.type != Filesystem::FileType::RawBytes) {
             throw AssetException { AssetException::Type::TypeMismatch,
                                    fmt::format("Expected type Raw, requested type was {}", detail::fileTypeToString(asset.type)) };
         }
 
-        return *std::static_pointer_cast<std::vector<uint8_t>>(asset.actualObject);
+        return std::static_pointer_cast<const ByteBuffer>(asset.actualObject);
     }
 
     graphics::ShaderPtr AssetManager::loadShader(const ShaderLoadingInfo& loadingInfo)
     {
-        HashAccessor accessor {};
-        XXH64_hash_t hash = XXH3_64bits(loadingInfo.path.data(), loadingInfo.path.size());
-
-        if (!cache_.find(accessor, hash)) {
-            if (loadingInfo.filesystem == nullptr) {
-                throw AssetException { AssetException::Type::NotInCache,
-                                       fmt::format("Requested asset '{}' wasn't in cache, and filesystem wasn't provided", loadingInfo.path) };
-            }
+        XXH64_hash_t hash = loadingInfo.path.hash();
 
-            Filesystem::Entry entry = loadingInfo.filesystem->getMetadata(loadingInfo.path);
+        Asset asset = acquireAsset(hash, [&]() {
+            Filesystem::Entry entry = requestMetadata(loadingInfo.filesystem, loadingInfo.path);
 
             if (entry.type != Filesystem::FileType::Shader) {
                 throw AssetException { AssetException::Type::TypeMismatch,
                                        fmt::format("Expected type Shader, requested type was {}", detail::fileTypeToString(entry.type)) };
             }
 
-            graphics::ShaderPtr shader =
-                graphics::ShaderModule::create(device_, loadingInfo.filesystem->getContent(loadingInfo.path), loadingInfo.entrypoint);
-            cache_.insert(std::make_pair(hash, Asset::create(shader)));
-
-            return shader;
-        }
-
-        auto& asset = accessor->second;
+            return Asset::create(
+                graphics::ShaderModule::create(device_, readContent(loadingInfo.filesystem, loadingInfo.path), loadingInfo.entrypoint)
+            );
+        });
 
         if (asset.type != Filesystem::FileType::Shader) {
             throw AssetException { AssetException::Type::TypeMismatch,
@@ -142,43 +516,20 @@ namespace coffee {
 
     graphics::ImagePtr AssetManager::loadImage(const ImageLoadingInfo& loadingInfo)
     {
-        HashAccessor accessor {};
-        XXH64_hash_t hash = XXH3_64bits(loadingInfo.path.data(), loadingInfo.path.size());
-
-        if (!cache_.find(accessor, hash)) {
-            if (loadingInfo.filesystem == nullptr) {
-                throw AssetException { AssetException::Type::NotInCache,
-                                       fmt::format("Requested asset '{}' wasn't in cache, and filesystem wasn't provided", loadingInfo.path) };
-            }
+        XXH64_hash_t hash = loadingInfo.path.hash();
 
-            Filesystem::Entry entry = loadingInfo.filesystem->getMetadata(loadingInfo.path);
+        Asset asset = acquireAsset(hash, [&]() {
+            Filesystem::Entry entry = requestMetadata(loadingInfo.filesystem, loadingInfo.path);
 
             if (entry.type != Filesystem::FileType::RawImage && entry.type != Filesystem::FileType::BasisImage) {
                 throw AssetException { AssetException::Type::TypeMismatch,
                                        fmt::format("Expected type Image, requested type was {}", detail::fileTypeToString(entry.type)) };
             }
 
-            graphics::ImagePtr image = nullptr;
-            std::vector<uint8_t> rawBytes = loadingInfo.filesystem->getContent(loadingInfo.path);
-
-            switch (entry.type) {
-                case Filesystem::FileType::RawImage:
-                    image = loadRawImage(rawBytes);
-                    break;
-                case Filesystem::FileType::BasisImage:
-                    image = loadBasisImage(rawBytes);
-                    break;
-                default:
-                    COFFEE_ASSERT(false, "Should not happen.");
-                    break;
-            }
-
-            cache_.insert(std::make_pair(hash, Asset::create(image)));
+            std::vector<uint8_t> rawBytes = readContent(loadingInfo.filesystem, loadingInfo.path);
 
-            return image;
-        }
-
-        auto& asset = accessor->second;
+            return Asset::create(submitImageUpload(decodeImage(entry.type, rawBytes, loadingInfo.generateMipmaps)));
+        });
 
         if (asset.type != Filesystem::FileType::RawImage) {
             throw AssetException { AssetException::Type::TypeMismatch,
@@ -190,29 +541,20 @@ namespace coffee {
 
     graphics::MeshPtr AssetManager::loadMesh(const MeshLoadingInfo& loadingInfo)
     {
-        HashAccessor accessor {};
-        XXH64_hash_t hash = XXH3_64bits(loadingInfo.path.data(), loadingInfo.path.size());
+        XXH64_hash_t hash = loadingInfo.path.hash();
 
-        if (!cache_.find(accessor, hash)) {
-            if (loadingInfo.filesystem == nullptr) {
-                throw AssetException { AssetException::Type::NotInCache,
-                                       fmt::format("Requested asset '{}' wasn't in cache, and filesystem wasn't provided", loadingInfo.path) };
-            }
-
-            Filesystem::Entry entry = loadingInfo.filesystem->getMetadata(loadingInfo.path);
+        Asset asset = acquireAsset(hash, [&]() {
+            Filesystem::Entry entry = requestMetadata(loadingInfo.filesystem, loadingInfo.path);
 
             if (entry.type != Filesystem::FileType::Mesh) {
                 throw AssetException { AssetException::Type::TypeMismatch,
                                        fmt::format("Expected type Mesh, requested type was {}", detail::fileTypeToString(entry.type)) };
             }
 
-            graphics::MeshPtr mesh = loadMesh(loadingInfo.filesystem, loadingInfo.path);
-            cache_.insert(std::make_pair(hash, Asset::create(mesh)));
-
-            return mesh;
-        }
+            ByteBufferPtr meshBytes = readBuffer(loadingInfo.filesystem, loadingInfo.path);
 
-        auto& asset = accessor->second;
+            return Asset::create(submitMeshUpload(decodeMesh(loadingInfo, meshBytes)));
+        });
 
         if (asset.type != Filesystem::FileType::Mesh) {
             throw AssetException { AssetException::Type::TypeMismatch,
@@ -222,472 +564,2227 @@ namespace coffee {
         return std::static_pointer_cast<graphics::Mesh>(asset.actualObject);
     }
 
-    void AssetManager::removeFromCache(const std::string& path) { cache_.erase(XXH3_64bits(path.data(), path.size())); }
-
-    void AssetManager::createMissingTexture()
+    audio::BufferPtr AssetManager::loadSound(const SoundLoadingInfo& loadingInfo)
     {
-        using namespace graphics;
+        XXH64_hash_t hash = loadingInfo.path.hash();
 
-        ImageConfiguration imageConfiguration {};
-        imageConfiguration.imageType = VK_IMAGE_TYPE_2D;
-        imageConfiguration.format = VK_FORMAT_R8G8_UNORM;
-        imageConfiguration.extent = { 16U, 16U, 1U };
-        imageConfiguration.mipLevels = 1U;
-        imageConfiguration.arrayLayers = 1U;
-        imageConfiguration.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageConfiguration.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imageConfiguration.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-        imageConfiguration.priority = 1.0f;
-        missingImage_ = Image::create(device_, imageConfiguration);
+        Asset asset = acquireAsset(hash, [&]() {
+            Filesystem::Entry entry = requestMetadata(loadingInfo.filesystem, loadingInfo.path);
 
-        BufferConfiguration stagingBufferConfiguration {};
-        stagingBufferConfiguration.instanceSize = 2U;
-        stagingBufferConfiguration.instanceCount = 16U * 16U;
-        stagingBufferConfiguration.usageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        stagingBufferConfiguration.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
-        stagingBufferConfiguration.allocationFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-        stagingBufferConfiguration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
-        auto stagingBuffer = Buffer::create(device_, stagingBufferConfiguration);
+            if (entry.type != Filesystem::FileType::WAV && entry.type != Filesystem::FileType::OGG) {
+                throw AssetException { AssetException::Type::TypeMismatch,
+                                       fmt::format("Expected type Audio, requested type was {}", detail::fileTypeToString(entry.type)) };
+            }
 
-        std::memcpy(stagingBuffer->memory(), detail::kMissingTextureBytes, sizeof(detail::kMissingTextureBytes) - 1U);
-        stagingBuffer->flush();
+            audio::BufferPtr sound = nullptr;
 
-        CommandBuffer transferCommandBuffer = CommandBuffer::createTransfer(device_);
-        VkImageMemoryBarrier barrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
-        VkBufferImageCopy copyRegion {};
+            switch (entry.type) {
+                case Filesystem::FileType::WAV:
+                    sound = loadWaveSound(*readBuffer(loadingInfo.filesystem, loadingInfo.path));
+                    break;
+                case Filesystem::FileType::OGG:
+                    sound = loadOggSound(*readBuffer(loadingInfo.filesystem, loadingInfo.path));
+                    break;
+                default:
+                    COFFEE_ASSERT(false, "Should not happen.");
+                    break;
+            }
 
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = missingImage_->image();
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.layerCount = 1;
-        transferCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier);
+            return Asset::create(std::move(sound));
+        });
 
-        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copyRegion.imageSubresource.layerCount = 1;
-        copyRegion.imageExtent.width = missingImage_->extent.width;
-        copyRegion.imageExtent.height = missingImage_->extent.height;
-        copyRegion.imageExtent.depth = missingImage_->extent.depth;
-        transferCommandBuffer.copyBufferToImage(stagingBuffer, missingImage_, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+        if (asset.type != Filesystem::FileType::WAV) {
+            throw AssetException { AssetException::Type::TypeMismatch,
+                                   fmt::format("Expected type Audio, requested type was {}", detail::fileTypeToString(asset.type)) };
+        }
 
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = device_->isUnifiedGraphicsTransferQueue() ? VK_ACCESS_SHADER_READ_BIT : static_cast<VkAccessFlags>(0);
-        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        barrier.srcQueueFamilyIndex = device_->transferQueueFamilyIndex();
-        barrier.dstQueueFamilyIndex = device_->graphicsQueueFamilyIndex();
-        barrier.image = missingImage_->image();
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.layerCount = 1;
-        VkPipelineStageFlagBits useStage =
-            device_->isUnifiedGraphicsTransferQueue() ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        return std::static_pointer_cast<audio::Buffer>(asset.actualObject);
+    }
 
-        transferCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, useStage, 0, 1, &barrier);
-        device_->submit(std::move(transferCommandBuffer), {}, nullptr, true);
+    std::vector<audio::BufferPtr> AssetManager::loadSounds(const std::vector<SoundLoadingInfo>& loadingInfos)
+    {
+        std::vector<audio::BufferPtr> sounds {};
+        sounds.resize(loadingInfos.size());
 
-        if (!device_->isUnifiedGraphicsTransferQueue()) {
-            CommandBuffer ownershipCommandBuffer = CommandBuffer::createGraphics(device_);
+        // Same sounds are still deduplicated, because every load goes through cache
+        tbb::parallel_for(size_t { 0 }, loadingInfos.size(), [&](size_t index) { sounds[index] = loadSound(loadingInfos[index]); });
 
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            barrier.srcQueueFamilyIndex = device_->transferQueueFamilyIndex();
-            barrier.dstQueueFamilyIndex = device_->graphicsQueueFamilyIndex();
-            barrier.image = missingImage_->image();
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.subresourceRange.levelCount = 1;
-            barrier.subresourceRange.layerCount = 1;
+        return sounds;
+    }
 
-            ownershipCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &barrier);
-            device_->submit(std::move(ownershipCommandBuffer), {}, nullptr, true);
+    PreloadProgress::PreloadProgress(std::shared_future<void>&& completion, size_t totalItems, size_t totalBytes)
+        : completion { std::move(completion) }
+        , totalItems_ { totalItems }
+        , totalBytes_ { totalBytes }
+    {}
+
+    LoadTicket::LoadTicket(const LoadRequest& request, std::shared_future<void>&& completion)
+        : completion { std::move(completion) }
+        , filesystem_ { request.filesystem }
+        , path_ { AssetId::intern(request.path.path()) }
+        , type_ { request.type }
+        , priority_ { request.priority }
+    {}
+
+    bool LoadTicket::cancel()
+    {
+        if (!transition(Status::Queued, Status::Cancelled) && !transition(Status::Reading, Status::Cancelled)) {
+            return false;
         }
 
-        ImageViewConfiguration viewConfiguration {};
-        viewConfiguration.viewType = VK_IMAGE_VIEW_TYPE_2D;
-        viewConfiguration.format = VK_FORMAT_R8G8_UNORM;
-        viewConfiguration.components.r = VK_COMPONENT_SWIZZLE_R;
-        viewConfiguration.components.g = VK_COMPONENT_SWIZZLE_ZERO;
-        viewConfiguration.components.b = VK_COMPONENT_SWIZZLE_G;
-        viewConfiguration.components.a = VK_COMPONENT_SWIZZLE_ONE;
-        missingTexture_ = ImageView::create(missingImage_, viewConfiguration);
+        // Ticket stays in queue until it's picked, scheduler simply skips it
+        promise_.set_value();
+        return true;
     }
 
-    void AssetManager::selectOneChannel()
+    LoadTicketPtr AssetManager::schedule(const LoadRequest& request)
     {
-        VkFormatProperties formatProperties;
+        COFFEE_ASSERT(request.filesystem != nullptr, "Invalid filesystem provided.");
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_BC4_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkOneChannel = VK_FORMAT_BC4_UNORM_BLOCK;
-            compressionTypes_.basisOneChannel = basist::transcoder_texture_format::cTFBC4_R;
-            return;
-        }
+        std::promise<void> promise {};
+        std::shared_future<void> completion = promise.get_future().share();
+        auto ticket = std::shared_ptr<LoadTicket>(new LoadTicket { request, std::move(completion) });
+        ticket->promise_ = std::move(promise);
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_EAC_R11_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkOneChannel = VK_FORMAT_EAC_R11_UNORM_BLOCK;
-            compressionTypes_.basisOneChannel = basist::transcoder_texture_format::cTFETC2_EAC_R11;
-            return;
-        }
+        bool startWorker = false;
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ASTC_4x4_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkOneChannel = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
-            compressionTypes_.basisOneChannel = basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
-            return;
+        {
+            tbb::queuing_mutex::scoped_lock lock { schedulerMutex_ };
+            scheduledLoads_.push_back(ticket);
+
+            if (activeSchedulerWorkers_ < schedulerConcurrency_) {
+                activeSchedulerWorkers_++;
+                startWorker = true;
+            }
         }
 
-        // TODO: Check whether this will ever work properly
-        compressionTypes_.vkOneChannel = VK_FORMAT_R8_UNORM;
-        compressionTypes_.basisOneChannel = basist::transcoder_texture_format::cTFRGBA32;
+        if (startWorker) {
+            backgroundTasks_.run([this]() { runScheduledLoads(); });
+        }
+
+        return ticket;
     }
 
-    void AssetManager::selectTwoChannels()
+    void AssetManager::runScheduledLoads()
     {
-        VkFormatProperties formatProperties;
+        while (LoadTicketPtr ticket = popScheduledLoad()) {
+            loadScheduledRequest(*ticket);
+        }
+    }
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_BC5_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkTwoChannels = VK_FORMAT_BC5_UNORM_BLOCK;
-            compressionTypes_.basisTwoChannels = basist::transcoder_texture_format::cTFBC5_RG;
-            return;
+    LoadTicketPtr AssetManager::popScheduledLoad()
+    {
+        tbb::queuing_mutex::scoped_lock lock { schedulerMutex_ };
+
+        // Cancelled tickets are dropped here, because cancel() doesn't know about queue
+        scheduledLoads_.erase(
+            std::remove_if(
+                scheduledLoads_.begin(),
+                scheduledLoads_.end(),
+                [](const LoadTicketPtr& ticket) { return ticket->status() == LoadTicket::Status::Cancelled; }
+            ),
+            scheduledLoads_.end()
+        );
+
+        if (scheduledLoads_.empty()) {
+            // Released under same lock as push in schedule(), so request can't be left in queue without worker
+            activeSchedulerWorkers_--;
+            return nullptr;
         }
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_EAC_R11G11_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkTwoChannels = VK_FORMAT_EAC_R11G11_UNORM_BLOCK;
-            compressionTypes_.basisTwoChannels = basist::transcoder_texture_format::cTFETC2_EAC_RG11;
+        auto highest = std::max_element(scheduledLoads_.begin(), scheduledLoads_.end(), [](const LoadTicketPtr& lhs, const LoadTicketPtr& rhs) {
+            return lhs->priority() < rhs->priority();
+        });
+
+        LoadTicketPtr ticket = std::move(*highest);
+        *highest = std::move(scheduledLoads_.back());
+        scheduledLoads_.pop_back();
+
+        return ticket;
+    }
+
+    void AssetManager::loadScheduledRequest(LoadTicket& ticket)
+    {
+        using Status = LoadTicket::Status;
+
+        if (!ticket.transition(Status::Queued, Status::Reading)) {
             return;
         }
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ASTC_4x4_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkTwoChannels = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
-            compressionTypes_.basisTwoChannels = basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
-            return;
+        const XXH64_hash_t hash = ticket.path_.hash();
+        const bool isImage = ticket.type_ == Filesystem::FileType::RawImage || ticket.type_ == Filesystem::FileType::BasisImage;
+
+        try {
+            Asset cachedAsset {};
+
+            if (findCachedAsset(hash, cachedAsset)) {
+                recordCacheHit(cachedAsset.type);
+
+                if (ticket.transition(Status::Reading, Status::Loaded)) {
+                    ticket.keepAlive_ = std::move(cachedAsset.actualObject);
+                    ticket.promise_.set_value();
+                }
+
+                return;
+            }
+
+            std::vector<uint8_t> rawBytes {};
+            Filesystem::FileType type = ticket.type_;
+
+            // Only images are split into read and decode, everything else is loaded as a whole
+            if (isImage) {
+                type = requestMetadata(ticket.filesystem_, ticket.path_).type;
+
+                if (type != Filesystem::FileType::RawImage && type != Filesystem::FileType::BasisImage) {
+                    throw AssetException { AssetException::Type::TypeMismatch,
+                                           fmt::format("Expected type Image, requested type was {}", detail::fileTypeToString(type)) };
+                }
+
+                rawBytes = readContent(ticket.filesystem_, ticket.path_);
+            }
+
+            if (!ticket.transition(Status::Reading, Status::Loading)) {
+                // Cancelled while file was read, so decoding is skipped entirely
+                return;
+            }
+
+            std::shared_ptr<void> loadedAsset = nullptr;
+
+            if (isImage) {
+                // Decoding is done by loader, so image that was loaded or is being loaded by somebody else in meantime isn't decoded twice
+                // Upload is done right after decode by this thread, so it never waits behind requests with lower priority
+                Asset asset = acquireAsset(hash, [&]() {
+                    ImageUpload upload = decodeImage(type, rawBytes, true);
+                    rawBytes = {};
+
+                    return Asset::create(submitImageUpload(std::move(upload)));
+                });
+
+                loadedAsset = std::move(asset.actualObject);
+            }
+            else {
+                PreloadEntry entry {};
+                entry.path = ticket.path_;
+                entry.type = ticket.type_;
+                loadedAsset = loadEntry(ticket.filesystem_, entry);
+            }
+
+            ticket.keepAlive_ = std::move(loadedAsset);
+            ticket.status_.store(Status::Loaded, std::memory_order_release);
+            ticket.promise_.set_value();
+        }
+        catch (...) {
+            // Either reading or loading state is owned by this thread, unless request was cancelled in meantime
+            if (ticket.transition(Status::Reading, Status::Failed) || ticket.transition(Status::Loading, Status::Failed)) {
+                ticket.promise_.set_exception(std::current_exception());
+            }
         }
+    }
 
-        // TODO: Check whether this will ever work properly
-        compressionTypes_.vkTwoChannels = VK_FORMAT_R8G8_UNORM;
-        compressionTypes_.basisTwoChannels = basist::transcoder_texture_format::cTFRGBA32;
+    PreloadProgressPtr AssetManager::preload(const PreloadManifest& manifest)
+    {
+        struct PreloadState {
+            FilesystemPtr filesystem;
+            std::vector<PreloadEntry> entries;
+            std::vector<size_t> entrySizes;
+            std::vector<std::shared_ptr<void>> loadedAssets;
+            std::promise<void> promise {};
+            std::exception_ptr firstError = nullptr;
+        };
+
+        // Single entry that goes through pipeline, either loadedAsset or error is set after load stage
+        struct PreloadItem {
+            size_t index;
+            XXH64_hash_t hash;
+            Filesystem::FileType type = Filesystem::FileType::RawBytes;
+            std::vector<uint8_t> rawBytes {};
+            ByteBufferPtr meshBytes = nullptr;
+            std::shared_ptr<void> loadedAsset = nullptr;
+            std::exception_ptr error = nullptr;
+        };
+
+        using PreloadItemPtr = std::unique_ptr<PreloadItem>;
+
+        COFFEE_ASSERT(manifest.filesystem != nullptr, "Invalid filesystem provided.");
+
+        auto state = std::make_shared<PreloadState>();
+        state->filesystem = manifest.filesystem;
+        state->entries = manifest.entries;
+
+        // Entries are processed in background, so their paths must outlive strings that user provided
+        for (auto& entry : state->entries) {
+            entry.path = AssetId::intern(entry.path.path());
+        }
+
+        state->entrySizes.resize(manifest.entries.size());
+        state->loadedAssets.resize(manifest.entries.size());
+
+        size_t totalBytes = 0ULL;
+
+        // Metadata is cheap compared to loading itself, and gives total amount of bytes right away
+        for (size_t index = 0; index < state->entries.size(); index++) {
+            // Missing files will be reported by actual load
+            if (Expected<Filesystem::Entry> entry = manifest.filesystem->tryGetMetadata(state->entries[index].path)) {
+                state->entrySizes[index] = entry->uncompressedSize;
+                totalBytes += state->entrySizes[index];
+            }
+        }
+
+        auto progress = std::shared_ptr<PreloadProgress>(
+            new PreloadProgress { state->promise.get_future().share(), state->entries.size(), totalBytes }
+        );
+
+        if (state->entries.empty()) {
+            state->promise.set_value();
+            return progress;
+        }
+
+        uint32_t concurrency = manifest.concurrency == 0 ? static_cast<uint32_t>(tbb::this_task_arena::max_concurrency()) : manifest.concurrency;
+        concurrency = std::min(concurrency, static_cast<uint32_t>(state->entries.size()));
+
+        // Pipeline is split into read -> load -> finish stages, so disk reads overlaps with decoding and submission of other entries
+        // Amount of tokens limits how many entries are in flight, which bounds memory used by read and decoded data
+        // Progress is captured weakly, otherwise it will keep itself alive through shared state
+        backgroundTasks_.run([this, state, concurrency, weakProgress = std::weak_ptr<PreloadProgress> { progress }]() {
+            size_t nextEntry = 0ULL;
+
+            auto readStage = [this, state](PreloadItemPtr item) -> PreloadItemPtr {
+                const PreloadEntry& entry = state->entries[item->index];
+                Asset cachedAsset {};
+
+                if (findCachedAsset(item->hash, cachedAsset)) {
+                    recordCacheHit(cachedAsset.type);
+                    item->loadedAsset = std::move(cachedAsset.actualObject);
+                    return item;
+                }
+
+                // Images and meshes are split between stages, everything else is loaded as a whole in load stage
+                if (!detail::isStagedType(entry.type)) {
+                    return item;
+                }
+
+                try {
+                    item->type = state->filesystem->getMetadata(entry.path).type;
+
+                    if (entry.type == Filesystem::FileType::Mesh) {
+                        if (item->type != Filesystem::FileType::Mesh) {
+                            throw AssetException { AssetException::Type::TypeMismatch,
+                                                   fmt::format("Expected type Mesh, requested type was {}", detail::fileTypeToString(item->type)) };
+                        }
+
+                        item->meshBytes = readBuffer(state->filesystem, entry.path);
+                        return item;
+                    }
+
+                    if (item->type != Filesystem::FileType::RawImage && item->type != Filesystem::FileType::BasisImage) {
+                        throw AssetException { AssetException::Type::TypeMismatch,
+                                               fmt::format("Expected type Image, requested type was {}", detail::fileTypeToString(item->type)) };
+                    }
+
+                    item->rawBytes = readContent(state->filesystem, entry.path);
+                }
+                catch (...) {
+                    item->error = std::current_exception();
+                }
+
+                return item;
+            };
+
+            // Decoding is done by loader, so duplicated entries and assets that are being loaded by somebody else aren't decoded twice
+            // Upload is done right after decode by the same thread, same as scheduled requests does
+            auto loadStage = [this, state](PreloadItemPtr item) -> PreloadItemPtr {
+                if (item->loadedAsset != nullptr || item->error != nullptr) {
+                    return item;
+                }
+
+                try {
+                    if (item->type == Filesystem::FileType::RawImage || item->type == Filesystem::FileType::BasisImage) {
+                        Asset asset = acquireAsset(item->hash, [&]() {
+                            ImageUpload upload = decodeImage(item->type, item->rawBytes, true);
+                            item->rawBytes = {};
+
+                            return Asset::create(submitImageUpload(std::move(upload)));
+                        });
+
+                        item->loadedAsset = std::move(asset.actualObject);
+                    }
+                    else if (item->type == Filesystem::FileType::Mesh) {
+                        MeshLoadingInfo loadingInfo {};
+                        loadingInfo.filesystem = state->filesystem;
+                        loadingInfo.path = state->entries[item->index].path;
+
+                        Asset asset = acquireAsset(item->hash, [&]() {
+                            MeshUpload upload = decodeMesh(loadingInfo, item->meshBytes);
+                            item->meshBytes = nullptr;
+
+                            return Asset::create(submitMeshUpload(std::move(upload)));
+                        });
+
+                        item->loadedAsset = std::move(asset.actualObject);
+                    }
+                    else {
+                        item->loadedAsset = loadEntry(state->filesystem, state->entries[item->index]);
+                    }
+                }
+                catch (...) {
+                    item->error = std::current_exception();
+                }
+
+                return item;
+            };
+
+            auto finishStage = [state, weakProgress](PreloadItemPtr item) {
+                const PreloadEntry& entry = state->entries[item->index];
+                auto progress = weakProgress.lock();
+
+                if (item->error == nullptr) {
+                    state->loadedAssets[item->index] = std::move(item->loadedAsset);
+
+                    if (progress != nullptr) {
+                        progress->loadedBytes_.fetch_add(state->entrySizes[item->index], std::memory_order_relaxed);
+                        progress->loadedItems_.fetch_add(1ULL, std::memory_order_relaxed);
+                    }
+
+                    return;
+                }
+
+                try {
+                    std::rethrow_exception(item->error);
+                }
+                catch (const std::exception& e) {
+                    COFFEE_ERROR("Failed to preload asset '{}': {}", entry.path.path(), e.what());
+                }
+
+                // Stage is serial, so no additional synchronization is required
+                if (state->firstError == nullptr) {
+                    state->firstError = item->error;
+                }
+
+                if (progress != nullptr) {
+                    progress->failedItems_.fetch_add(1ULL, std::memory_order_relaxed);
+                }
+            };
+
+            // Stages catch their own errors, but pipeline itself might still throw (e.g. when it fails to allocate an item)
+            // Progress must be resolved in any case, otherwise everybody who waits for it will wait forever
+            try {
+                tbb::parallel_pipeline(
+                    concurrency,
+                    tbb::make_filter<void, PreloadItemPtr>(
+                        tbb::filter_mode::serial_in_order,
+                        [state, &nextEntry](tbb::flow_control& control) -> PreloadItemPtr {
+                            if (nextEntry >= state->entries.size()) {
+                                control.stop();
+                                return nullptr;
+                            }
+
+                            const PreloadEntry& entry = state->entries[nextEntry];
+
+                            auto item = std::make_unique<PreloadItem>();
+                            item->index = nextEntry++;
+                            item->hash = entry.path.hash();
+                            return item;
+                        }
+                    ) &
+                        tbb::make_filter<PreloadItemPtr, PreloadItemPtr>(tbb::filter_mode::parallel, readStage) &
+                        tbb::make_filter<PreloadItemPtr, PreloadItemPtr>(tbb::filter_mode::parallel, loadStage) &
+                        tbb::make_filter<PreloadItemPtr, void>(tbb::filter_mode::serial_out_of_order, finishStage)
+                );
+            }
+            catch (...) {
+                COFFEE_ERROR("Preload pipeline was interrupted, remaining entries won't be loaded.");
+                state->promise.set_exception(std::current_exception());
+                return;
+            }
+
+            if (state->firstError != nullptr) {
+                state->promise.set_exception(state->firstError);
+            }
+            else {
+                state->promise.set_value();
+            }
+        });
+
+        // Loaded assets are owned by shared state, so progress must keep it alive
+        progress->keepAlive_ = state;
+
+        return progress;
     }
 
-    void AssetManager::selectThreeChannels()
+    std::shared_ptr<void> AssetManager::loadEntry(const FilesystemPtr& filesystem, const PreloadEntry& entry)
     {
-        VkFormatProperties formatProperties;
+        switch (entry.type) {
+            case Filesystem::FileType::RawBytes: {
+                BytesLoadingInfo loadingInfo {};
+                loadingInfo.filesystem = filesystem;
+                loadingInfo.path = entry.path;
+                return std::const_pointer_cast<ByteBuffer>(loadBytes(loadingInfo));
+            }
+            case Filesystem::FileType::Shader: {
+                ShaderLoadingInfo loadingInfo {};
+                loadingInfo.filesystem = filesystem;
+                loadingInfo.path = entry.path;
+                return loadShader(loadingInfo);
+            }
+            case Filesystem::FileType::Mesh: {
+                MeshLoadingInfo loadingInfo {};
+                loadingInfo.filesystem = filesystem;
+                loadingInfo.path = entry.path;
+                return loadMesh(loadingInfo);
+            }
+            case Filesystem::FileType::RawImage:
+            case Filesystem::FileType::BasisImage: {
+                ImageLoadingInfo loadingInfo {};
+                loadingInfo.filesystem = filesystem;
+                loadingInfo.path = entry.path;
+                return loadImage(loadingInfo);
+            }
+            case Filesystem::FileType::WAV:
+            case Filesystem::FileType::OGG: {
+                SoundLoadingInfo loadingInfo {};
+                loadingInfo.filesystem = filesystem;
+                loadingInfo.path = entry.path;
+                return loadSound(loadingInfo);
+            }
+            default:
+                throw AssetException { AssetException::Type::InvalidRequest, fmt::format("Unknown asset type of '{}'", entry.path.path()) };
+        }
+    }
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_BC1_RGB_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkThreeChannels = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
-            compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFBC1_RGB;
+    void AssetManager::removeFromCache(const AssetId& id)
+    {
+        XXH64_hash_t hash = id.hash();
+
+        cache_.erase(hash);
+        forgetAsset(hash);
+    }
+
+    void AssetManager::pin(const AssetId& id)
+    {
+        tbb::concurrent_hash_map<XXH64_hash_t, Asset>::accessor accessor {};
+
+        if (!cache_.find(accessor, id.hash())) {
+            throw AssetException { AssetException::Type::NotInCache,
+                                   fmt::format("Requested asset '{}' cannot be pinned because it isn't in cache", id.path()) };
+        }
+
+        auto& asset = accessor->second;
+
+        // Weak entries must hold strong reference while pinned, otherwise pin doesn't make any sense
+        if (asset.actualObject == nullptr && (asset.actualObject = asset.weakObject.lock()) == nullptr) {
+            throw AssetException { AssetException::Type::NotInCache,
+                                   fmt::format("Requested asset '{}' cannot be pinned because it expired", id.path()) };
+        }
+
+        asset.residency->pinCount.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    void AssetManager::unpin(const AssetId& id)
+    {
+        tbb::concurrent_hash_map<XXH64_hash_t, Asset>::accessor accessor {};
+
+        if (!cache_.find(accessor, id.hash())) {
+            throw AssetException { AssetException::Type::NotInCache,
+                                   fmt::format("Requested asset '{}' cannot be unpinned because it isn't in cache", id.path()) };
+        }
+
+        auto& asset = accessor->second;
+        uint32_t previousCount = asset.residency->pinCount.fetch_sub(1U, std::memory_order_relaxed);
+        COFFEE_ASSERT(previousCount > 0, "Asset '{}' was unpinned more times than it was pinned.", id.path());
+
+        if (weakReferences_ && previousCount == 1) {
+            asset.actualObject = nullptr;
+        }
+    }
+
+    std::vector<AssetId> AssetManager::dependencies(const AssetId& id)
+    {
+        tbb::queuing_mutex::scoped_lock lock { dependencyMutex_ };
+
+        if (auto it = dependencyGraph_.find(id.hash()); it != dependencyGraph_.end()) {
+            return it->second.dependencies;
+        }
+
+        return {};
+    }
+
+    std::vector<AssetId> AssetManager::dependents(const AssetId& id)
+    {
+        tbb::queuing_mutex::scoped_lock lock { dependencyMutex_ };
+        std::vector<AssetId> result {};
+
+        if (auto it = dependencyGraph_.find(id.hash()); it != dependencyGraph_.end()) {
+            result.reserve(it->second.dependents.size());
+
+            for (XXH64_hash_t dependent : it->second.dependents) {
+                result.push_back(dependencyGraph_.at(dependent).id);
+            }
+        }
+
+        return result;
+    }
+
+    TextureHandle AssetManager::acquireTexture(const ImageLoadingInfo& loadingInfo)
+    {
+        return textureHandles_.acquire(loadingInfo.path.hash(), loadImage(loadingInfo));
+    }
+
+    MeshHandle AssetManager::acquireMesh(const MeshLoadingInfo& loadingInfo)
+    {
+        return meshHandles_.acquire(loadingInfo.path.hash(), loadMesh(loadingInfo));
+    }
+
+    ShaderHandle AssetManager::acquireShader(const ShaderLoadingInfo& loadingInfo)
+    {
+        return shaderHandles_.acquire(loadingInfo.path.hash(), loadShader(loadingInfo));
+    }
+
+    void AssetManager::release(TextureHandle handle)
+    {
+        [[maybe_unused]] bool released = textureHandles_.release(handle, currentFrame_.load(std::memory_order_relaxed));
+        COFFEE_ASSERT(released, "Texture handle was released more times than it was acquired.");
+    }
+
+    void AssetManager::release(MeshHandle handle)
+    {
+        [[maybe_unused]] bool released = meshHandles_.release(handle, currentFrame_.load(std::memory_order_relaxed));
+        COFFEE_ASSERT(released, "Mesh handle was released more times than it was acquired.");
+    }
+
+    void AssetManager::release(ShaderHandle handle)
+    {
+        [[maybe_unused]] bool released = shaderHandles_.release(handle, currentFrame_.load(std::memory_order_relaxed));
+        COFFEE_ASSERT(released, "Shader handle was released more times than it was acquired.");
+    }
+
+    void AssetManager::update()
+    {
+        const uint64_t currentFrame = currentFrame_.fetch_add(1ULL, std::memory_order_relaxed) + 1ULL;
+        stagingRing_->reclaim();
+
+        // Released handles must be collected before eviction, otherwise their assets will be evicted only next frame
+        textureHandles_.collect(currentFrame);
+        meshHandles_.collect(currentFrame);
+        shaderHandles_.collect(currentFrame);
+
+        if (streamingBytesPerFrame_ > 0) {
+            streamImages();
+        }
+
+        if (weakReferences_) {
+            // Nothing to evict in weak mode because every alive asset is referenced by user, so only expired entries are swept
+            return sweepExpiredAssets();
+        }
+
+        std::vector<EvictionCandidate> candidates {};
+        size_t residentBytes = 0ULL;
+
+        {
+            tbb::queuing_mutex::scoped_lock lock { residencyMutex_ };
+
+            for (auto& [hash, residency] : residency_) {
+                residentBytes += residency->cpuBytes + residency->gpuBytes;
+
+                // Cache itself always holds one reference
+                if (residency->object.use_count() > 1) {
+                    residency->unreferencedSince = Residency::kReferenced;
+                    continue;
+                }
+
+                if (residency->unreferencedSince == Residency::kReferenced) {
+                    residency->unreferencedSince = currentFrame;
+                }
+
+                // Frames that was recorded before user released last reference might still use this asset on GPU
+                bool mightBeInFlight = currentFrame - residency->unreferencedSince < graphics::Device::kMaxOperationsInFlight;
+
+                if (!mightBeInFlight && residency->pinCount.load(std::memory_order_relaxed) == 0) {
+                    candidates.emplace_back(hash, residency, residency->lastUsedFrame.load(std::memory_order_relaxed));
+                }
+            }
+        }
+
+        // Dependencies that lost their last dependent are released regardless of budget, because nobody is going to use them
+        residentBytes -= std::min(residentBytes, evictOrphanedAssets(candidates));
+
+        size_t budgetOverflow = (memoryBudget_ != 0 && residentBytes > memoryBudget_) ? residentBytes - memoryBudget_ : 0ULL;
+        size_t heapOverflow = 0ULL;
+
+        const VkPhysicalDeviceMemoryProperties& memoryProperties = device_->memoryProperties();
+        const std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> heapBudgets = device_->heapBudgets();
+
+        for (uint32_t heapIndex = 0; heapIndex < memoryProperties.memoryHeapCount; heapIndex++) {
+            if ((memoryProperties.memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) == 0) {
+                continue;
+            }
+
+            const VmaBudget& heapBudget = heapBudgets[heapIndex];
+            VkDeviceSize threshold = static_cast<VkDeviceSize>(static_cast<double>(heapBudget.budget) * heapPressureThreshold_);
+
+            if (heapBudget.usage > threshold) {
+                heapOverflow += static_cast<size_t>(heapBudget.usage - threshold);
+            }
+        }
+
+        if ((budgetOverflow == 0 && heapOverflow == 0) || candidates.empty()) {
             return;
         }
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkThreeChannels = VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
-            compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFETC1_RGB;
-            return;
+        std::sort(candidates.begin(), candidates.end(), [](const EvictionCandidate& lhs, const EvictionCandidate& rhs) {
+            return std::get<2>(lhs) < std::get<2>(rhs);
+        });
+
+        for (const auto& [hash, residency, lastUsedFrame] : candidates) {
+            if (budgetOverflow == 0 && heapOverflow == 0) {
+                break;
+            }
+
+            // Heap pressure can only be relieved by GPU assets
+            if (budgetOverflow == 0 && residency->gpuBytes == 0) {
+                continue;
+            }
+
+            {
+                // Exclusive accessor guarantees that nobody will receive this asset while it's checked and erased
+                tbb::concurrent_hash_map<XXH64_hash_t, Asset>::accessor accessor {};
+
+                if (!cache_.find(accessor, hash) || accessor->second.actualObject.use_count() > 1 ||
+                    residency->pinCount.load(std::memory_order_relaxed) > 0) {
+                    continue;
+                }
+
+                cache_.erase(accessor);
+            }
+
+            forgetAsset(hash);
+
+            size_t freedBytes = residency->cpuBytes + residency->gpuBytes;
+            budgetOverflow -= std::min(budgetOverflow, freedBytes);
+            heapOverflow -= std::min(heapOverflow, residency->gpuBytes);
+        }
+    }
+
+    AssetStatistics AssetManager::statistics() const noexcept
+    {
+        AssetStatistics result {};
+
+        for (size_t index = 0; index < AssetStatistics::kAmountOfFileTypes; index++) {
+            const TypeCounters& counters = typeCounters_[index];
+            AssetStatistics::TypeStatistics& statistics = result.types[index];
+
+            statistics.hits = counters.hits.load(std::memory_order_relaxed);
+            statistics.misses = counters.misses.load(std::memory_order_relaxed);
+            statistics.cpuBytes = counters.cpuBytes.load(std::memory_order_relaxed);
+            statistics.gpuBytes = counters.gpuBytes.load(std::memory_order_relaxed);
+        }
+
+        for (size_t index = 0; index < stageLatencies_.size(); index++) {
+            result.stages[index] = stageLatencies_[index].summary();
+        }
+
+        // GPU completion is only observable by staging ring, because it's the one who owns fences
+        result.stages[static_cast<size_t>(AssetStatistics::Stage::GpuWait)] = stagingRing_->completionLatency().summary();
+
+        result.inFlightLoads = inFlightLoads_.load(std::memory_order_relaxed);
+        result.failedLoads = failedLoads_.load(std::memory_order_relaxed);
+
+        return result;
+    }
+
+    std::string AssetStatistics::toJson() const
+    {
+        constexpr Filesystem::FileType kAssetTypes[] = { Filesystem::FileType::RawBytes,
+                                                         Filesystem::FileType::Shader,
+                                                         Filesystem::FileType::Mesh,
+                                                         Filesystem::FileType::RawImage,
+                                                         Filesystem::FileType::WAV };
+        constexpr std::string_view kStageNames[kAmountOfStages] = { "Read", "Decompress", "Transcode", "Staging", "GpuWait" };
+
+        std::string result = fmt::format("{{\"inFlightLoads\":{},\"failedLoads\":{},\"types\":{{", inFlightLoads, failedLoads);
+
+        for (Filesystem::FileType type : kAssetTypes) {
+            const TypeStatistics& statistics = types[static_cast<size_t>(type)];
+
+            result += fmt::format(
+                "{}\"{}\":{{\"hits\":{},\"misses\":{},\"cpuBytes\":{},\"gpuBytes\":{}}}",
+                type == kAssetTypes[0] ? "" : ",",
+                detail::fileTypeToString(type),
+                statistics.hits,
+                statistics.misses,
+                statistics.cpuBytes,
+                statistics.gpuBytes
+            );
+        }
+
+        result += "},\"stages\":{";
+
+        for (size_t index = 0; index < kAmountOfStages; index++) {
+            const LatencyHistogram::Summary& summary = stages[index];
+
+            result += fmt::format(
+                "{}\"{}\":{{\"samples\":{},\"totalMicroseconds\":{},\"maxMicroseconds\":{},\"p50Microseconds\":{},\"p99Microseconds\":{}}}",
+                index == 0 ? "" : ",",
+                kStageNames[index],
+                summary.samples,
+                summary.totalMicroseconds,
+                summary.maxMicroseconds,
+                summary.p50Microseconds,
+                summary.p99Microseconds
+            );
+        }
+
+        result += "}}";
+
+        return result;
+    }
+
+    void AssetManager::recordCacheHit(Filesystem::FileType type) noexcept
+    {
+        typeCounters_[static_cast<size_t>(type)].hits.fetch_add(1ULL, std::memory_order_relaxed);
+    }
+
+    void AssetManager::sweepExpiredAssets()
+    {
+        std::vector<XXH64_hash_t> expiredAssets {};
+
+        {
+            tbb::queuing_mutex::scoped_lock lock { residencyMutex_ };
+
+            for (const auto& [hash, residency] : residency_) {
+                if (residency->object.expired()) {
+                    expiredAssets.push_back(hash);
+                }
+            }
+        }
+
+        for (XXH64_hash_t hash : expiredAssets) {
+            {
+                tbb::concurrent_hash_map<XXH64_hash_t, Asset>::accessor accessor {};
+
+                // Entry might be reloaded since residency was checked
+                if (!cache_.find(accessor, hash) || !accessor->second.weakObject.expired()) {
+                    continue;
+                }
+
+                cache_.erase(accessor);
+            }
+
+            forgetAsset(hash);
+        }
+    }
+
+    void AssetManager::streamImages()
+    {
+        size_t uploadedBytes = 0ULL;
+        size_t amountOfImages = 0ULL;
+
+        {
+            tbb::queuing_mutex::scoped_lock lock { streamingMutex_ };
+            amountOfImages = streamingImages_.size();
+        }
+
+        // Every image receives at most one level per call, so all images are progressing evenly instead of one by one
+        for (size_t index = 0; index < amountOfImages; index++) {
+            std::shared_ptr<StreamingImage> streamingImage = nullptr;
+
+            {
+                tbb::queuing_mutex::scoped_lock lock { streamingMutex_ };
+
+                if (streamingImages_.empty()) {
+                    break;
+                }
+
+                // Level that doesn't fit into what's left of budget waits for next call, so budget is exceeded only by level that is bigger than it
+                const size_t levelSize = streamingImages_.front()->transcodedBytes.size();
+
+                if (uploadedBytes > 0 && uploadedBytes + levelSize > streamingBytesPerFrame_) {
+                    break;
+                }
+
+                streamingImage = std::move(streamingImages_.front());
+                streamingImages_.pop_front();
+            }
+
+            graphics::ImagePtr image = streamingImage->image.lock();
+
+            // User already dropped this image, so there no point of streaming it
+            if (image == nullptr) {
+                continue;
+            }
+
+            const uint32_t mipLevel = streamingImage->nextMipLevel;
+
+            try {
+                graphics::StagingRegion stagingRegion = stagingRing_->allocate(streamingImage->transcodedBytes.size());
+                std::memcpy(stagingRegion.memory, streamingImage->transcodedBytes.data(), streamingImage->transcodedBytes.size());
+                stagingRegion.flush();
+
+                uploadedBytes += stagingRegion.size;
+                uploadStreamedLevel(std::move(stagingRegion), image, std::move(streamingImage->copyRegions), mipLevel);
+                image->setResidentMipLevel(mipLevel);
+            }
+            catch (const std::exception& e) {
+                COFFEE_ERROR("Failed to stream mip level {} of image: {}", mipLevel, e.what());
+                continue;
+            }
+
+            streamingImage->transcodedBytes = {};
+            streamingImage->copyRegions = {};
+
+            if (mipLevel > 0) {
+                streamingImage->nextMipLevel = mipLevel - 1;
+                transcodeStreamingLevel(std::move(streamingImage));
+            }
+
+            if (uploadedBytes >= streamingBytesPerFrame_) {
+                break;
+            }
+        }
+    }
+
+    void AssetManager::transcodeStreamingLevel(std::shared_ptr<StreamingImage> streamingImage)
+    {
+        // Whole level takes too long to be transcoded on thread that calls update(), so update() only uploads levels that are ready
+        backgroundTasks_.run([this, streamingImage = std::move(streamingImage)]() {
+            // User already dropped this image, so there no point of streaming it
+            if (streamingImage->image.expired()) {
+                return;
+            }
+
+            StreamingImage& state = *streamingImage;
+
+            try {
+                state.transcodedBytes.resize(layoutBasisLevels(*state.transcoder, state.format, state.nextMipLevel, 1U, state.copyRegions));
+                transcodeBasisRegions(*state.transcoder, state.format, state.copyRegions, state.transcodedBytes.data());
+            }
+            catch (const std::exception& e) {
+                COFFEE_ERROR("Failed to stream mip level {} of image: {}", state.nextMipLevel, e.what());
+                return;
+            }
+
+            tbb::queuing_mutex::scoped_lock lock { streamingMutex_ };
+            streamingImages_.push_back(streamingImage);
+        });
+    }
+
+    void AssetManager::measureAsset(Asset& asset)
+    {
+        asset.residency = std::make_shared<Residency>();
+        asset.residency->type = asset.type;
+        asset.residency->object = asset.actualObject;
+        asset.residency->lastUsedFrame.store(currentFrame_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        switch (asset.type) {
+            case Filesystem::FileType::RawBytes: {
+                auto bytes = std::static_pointer_cast<ByteBuffer>(asset.actualObject);
+                // Aliased bytes belongs to mapped archive, so they doesn't take any additional memory
+                asset.residency->cpuBytes = bytes->ownsStorage() ? bytes->size() : 0ULL;
+                break;
+            }
+            case Filesystem::FileType::Mesh: {
+                auto mesh = std::static_pointer_cast<graphics::Mesh>(asset.actualObject);
+                // Meshes without indices are drawn directly from vertices, so they doesn't have index buffer at all
+                asset.residency->gpuBytes =
+                    mesh->verticesBuffer->allocationSize() + (mesh->indicesBuffer != nullptr ? mesh->indicesBuffer->allocationSize() : 0ULL);
+
+                // Separate positions stream is optional too and only exists for meshes loaded with positionsStream
+                if (mesh->positionsBuffer != nullptr) {
+                    asset.residency->gpuBytes += mesh->positionsBuffer->allocationSize();
+                }
+                break;
+            }
+            case Filesystem::FileType::RawImage:
+                asset.residency->gpuBytes = std::static_pointer_cast<graphics::Image>(asset.actualObject)->allocationSize();
+                break;
+            case Filesystem::FileType::WAV:
+                asset.residency->cpuBytes = std::static_pointer_cast<audio::Buffer>(asset.actualObject)->size();
+                break;
+            default:
+                break;
+        }
+    }
+
+    void AssetManager::forgetAsset(XXH64_hash_t hash)
+    {
+        {
+            tbb::queuing_mutex::scoped_lock lock { residencyMutex_ };
+
+            if (auto it = residency_.find(hash); it != residency_.end()) {
+                trackResidentBytes(*it->second, false);
+                residency_.erase(it);
+            }
+        }
+
+        releaseDependencies(hash);
+    }
+
+    void AssetManager::declareDependencies(const AssetId& id, const std::vector<std::string>& paths)
+    {
+        std::vector<AssetId> dependencies {};
+        dependencies.reserve(paths.size());
+
+        for (const auto& path : paths) {
+            dependencies.push_back(AssetId::intern(path));
+        }
+
+        tbb::queuing_mutex::scoped_lock lock { dependencyMutex_ };
+        DependencyNode& node = dependencyGraph_[id.hash()];
+
+        // Reloaded asset might reference different files than it was before
+        for (const AssetId& dependency : node.dependencies) {
+            dependencyGraph_[dependency.hash()].dependents.erase(id.hash());
+        }
+
+        for (const AssetId& dependency : dependencies) {
+            DependencyNode& dependencyNode = dependencyGraph_[dependency.hash()];
+            dependencyNode.id = dependency;
+            dependencyNode.dependents.insert(id.hash());
+        }
+
+        node.id = AssetId::intern(id.path());
+        node.dependencies = std::move(dependencies);
+    }
+
+    void AssetManager::releaseDependencies(XXH64_hash_t hash)
+    {
+        tbb::queuing_mutex::scoped_lock lock { dependencyMutex_ };
+        auto it = dependencyGraph_.find(hash);
+
+        if (it == dependencyGraph_.end()) {
+            return;
+        }
+
+        // Forward edges are kept, so next load of this asset can prefetch it's dependencies
+        for (const AssetId& dependency : it->second.dependencies) {
+            DependencyNode& dependencyNode = dependencyGraph_[dependency.hash()];
+            dependencyNode.dependents.erase(hash);
+
+            // Weak cache doesn't own anything, so dependencies are released by user references instead
+            if (dependencyNode.dependents.empty() && !weakReferences_) {
+                orphanedAssets_.push_back(dependency.hash());
+            }
+        }
+    }
+
+    size_t AssetManager::evictOrphanedAssets(const std::vector<EvictionCandidate>& candidates)
+    {
+        std::vector<XXH64_hash_t> orphans {};
+        std::vector<XXH64_hash_t> stillInFlight {};
+        size_t freedBytes = 0ULL;
+
+        {
+            tbb::queuing_mutex::scoped_lock lock { dependencyMutex_ };
+            orphans.swap(orphanedAssets_);
+        }
+
+        if (orphans.empty()) {
+            return 0ULL;
+        }
+
+        std::sort(orphans.begin(), orphans.end());
+        orphans.erase(std::unique(orphans.begin(), orphans.end()), orphans.end());
+
+        std::unordered_map<XXH64_hash_t, Residency*> evictable {};
+        evictable.reserve(candidates.size());
+
+        for (const auto& [hash, residency, lastUsedFrame] : candidates) {
+            evictable.emplace(hash, residency.get());
+        }
+
+        for (XXH64_hash_t hash : orphans) {
+            {
+                tbb::queuing_mutex::scoped_lock lock { dependencyMutex_ };
+
+                // Another asset might declare this one as dependency since it was orphaned
+                if (!dependencyGraph_[hash].dependents.empty()) {
+                    continue;
+                }
+            }
+
+            auto it = evictable.find(hash);
+
+            {
+                tbb::concurrent_hash_map<XXH64_hash_t, Asset>::accessor accessor {};
+
+                if (!cache_.find(accessor, hash) || accessor->second.actualObject.use_count() > 1 ||
+                    accessor->second.residency->pinCount.load(std::memory_order_relaxed) > 0) {
+                    // Assets that are held by user or pinned are left to regular eviction
+                    continue;
+                }
+
+                if (it == evictable.end()) {
+                    // Frames that was recorded before mesh was released might still use this asset on GPU
+                    stillInFlight.push_back(hash);
+                    continue;
+                }
+
+                cache_.erase(accessor);
+            }
+
+            // Orphan might have dependencies of it's own, they will be released in next frame
+            forgetAsset(hash);
+            freedBytes += it->second->cpuBytes + it->second->gpuBytes;
+        }
+
+        if (!stillInFlight.empty()) {
+            tbb::queuing_mutex::scoped_lock lock { dependencyMutex_ };
+            orphanedAssets_.insert(orphanedAssets_.end(), stillInFlight.begin(), stillInFlight.end());
+        }
+
+        return freedBytes;
+    }
+
+    void AssetManager::trackResidentBytes(const Residency& residency, bool resident) noexcept
+    {
+        TypeCounters& counters = typeCounters_[static_cast<size_t>(residency.type)];
+
+        if (resident) {
+            counters.cpuBytes.fetch_add(residency.cpuBytes, std::memory_order_relaxed);
+            counters.gpuBytes.fetch_add(residency.gpuBytes, std::memory_order_relaxed);
+        }
+        else {
+            counters.cpuBytes.fetch_sub(residency.cpuBytes, std::memory_order_relaxed);
+            counters.gpuBytes.fetch_sub(residency.gpuBytes, std::memory_order_relaxed);
+        }
+    }
+
+    void AssetManager::createMissingTexture()
+    {
+        using namespace graphics;
+
+        ImageConfiguration imageConfiguration {};
+        imageConfiguration.imageType = VK_IMAGE_TYPE_2D;
+        imageConfiguration.format = VK_FORMAT_R8G8_UNORM;
+        imageConfiguration.extent = { 16U, 16U, 1U };
+        imageConfiguration.mipLevels = 1U;
+        imageConfiguration.arrayLayers = 1U;
+        imageConfiguration.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageConfiguration.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageConfiguration.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageConfiguration.priority = 1.0f;
+        missingImage_ = Image::create(device_, imageConfiguration);
+
+        StagingRegion stagingRegion = stagingRing_->allocate(sizeof(detail::kMissingTextureBytes) - 1U);
+        std::memcpy(stagingRegion.memory, detail::kMissingTextureBytes, sizeof(detail::kMissingTextureBytes) - 1U);
+        stagingRegion.flush();
+
+        VkBufferImageCopy copyRegion {};
+        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageExtent.width = missingImage_->extent.width;
+        copyRegion.imageExtent.height = missingImage_->extent.height;
+        copyRegion.imageExtent.depth = missingImage_->extent.depth;
+        uploadImage(std::move(stagingRegion), missingImage_, { copyRegion }, 0U, missingImage_->mipLevels);
+
+        ImageViewConfiguration viewConfiguration {};
+        viewConfiguration.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewConfiguration.format = VK_FORMAT_R8G8_UNORM;
+        viewConfiguration.components.r = VK_COMPONENT_SWIZZLE_R;
+        viewConfiguration.components.g = VK_COMPONENT_SWIZZLE_ZERO;
+        viewConfiguration.components.b = VK_COMPONENT_SWIZZLE_G;
+        viewConfiguration.components.a = VK_COMPONENT_SWIZZLE_ONE;
+        missingTexture_ = ImageView::create(missingImage_, viewConfiguration);
+    }
+
+    void AssetManager::selectOneChannel()
+    {
+        VkFormatProperties formatProperties;
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_BC4_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkOneChannel = VK_FORMAT_BC4_UNORM_BLOCK;
+            compressionTypes_.basisOneChannel = basist::transcoder_texture_format::cTFBC4_R;
+            return;
+        }
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_EAC_R11_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkOneChannel = VK_FORMAT_EAC_R11_UNORM_BLOCK;
+            compressionTypes_.basisOneChannel = basist::transcoder_texture_format::cTFETC2_EAC_R11;
+            return;
+        }
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ASTC_4x4_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkOneChannel = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+            compressionTypes_.basisOneChannel = basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
+            return;
+        }
+
+        // TODO: Check whether this will ever work properly
+        compressionTypes_.vkOneChannel = VK_FORMAT_R8_UNORM;
+        compressionTypes_.basisOneChannel = basist::transcoder_texture_format::cTFRGBA32;
+    }
+
+    void AssetManager::selectTwoChannels()
+    {
+        VkFormatProperties formatProperties;
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_BC5_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkTwoChannels = VK_FORMAT_BC5_UNORM_BLOCK;
+            compressionTypes_.basisTwoChannels = basist::transcoder_texture_format::cTFBC5_RG;
+            return;
+        }
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_EAC_R11G11_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkTwoChannels = VK_FORMAT_EAC_R11G11_UNORM_BLOCK;
+            compressionTypes_.basisTwoChannels = basist::transcoder_texture_format::cTFETC2_EAC_RG11;
+            return;
+        }
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ASTC_4x4_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkTwoChannels = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+            compressionTypes_.basisTwoChannels = basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
+            return;
+        }
+
+        // TODO: Check whether this will ever work properly
+        compressionTypes_.vkTwoChannels = VK_FORMAT_R8G8_UNORM;
+        compressionTypes_.basisTwoChannels = basist::transcoder_texture_format::cTFRGBA32;
+    }
+
+    void AssetManager::selectThreeChannels()
+    {
+        VkFormatProperties formatProperties;
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_BC1_RGB_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkThreeChannels = VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFBC1_RGB;
+            return;
+        }
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkThreeChannels = VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK;
+            compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFETC1_RGB;
+            return;
+        }
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ASTC_4x4_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkThreeChannels = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+            compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
+            return;
+        }
+
+        // This must work properly because most GPU's doesn't support R8G8B8 (24 bits) because of misalignment
+        compressionTypes_.vkThreeChannels = VK_FORMAT_R8G8B8A8_UNORM;
+        compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFRGBA32;
+    }
+
+    void AssetManager::selectFourChannels()
+    {
+        VkFormatProperties formatProperties;
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_BC7_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkFourChannels = VK_FORMAT_BC7_UNORM_BLOCK;
+            compressionTypes_.basisFourChannels = basist::transcoder_texture_format::cTFBC7_RGBA;
+            return;
+        }
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkFourChannels = VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
+            compressionTypes_.basisFourChannels = basist::transcoder_texture_format::cTFETC2_RGBA;
+            return;
+        }
+
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ASTC_4x4_UNORM_BLOCK, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
+            compressionTypes_.vkFourChannels = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
+            compressionTypes_.basisFourChannels = basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
+            return;
+        }
+
+        compressionTypes_.vkFourChannels = VK_FORMAT_R8G8B8A8_UNORM;
+        compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFRGBA32;
+    }
+
+    AssetManager::MeshUpload AssetManager::decodeMesh(const MeshLoadingInfo& loadingInfo, const ByteBufferPtr& meshBytes)
+    {
+        using namespace graphics;
+
+        const FilesystemPtr& filesystem = loadingInfo.filesystem;
+        const AssetId& id = loadingInfo.path;
+        const bool asyncTextures = loadingInfo.asyncTextures;
+
+        // Dependencies are known if this mesh was loaded before, so textures are loaded while mesh itself is parsed
+        // Failures are ignored here because they will be reported by actual load of textures
+        tbb::task_group dependencyLoads {};
+        ScopeGuard dependencyGuard { [&dependencyLoads]() { dependencyLoads.wait(); } };
+
+        if (!asyncTextures) {
+            for (const AssetId& dependency : dependencies(id)) {
+                dependencyLoads.run([this, filesystem, dependency]() {
+                    try {
+                        ImageLoadingInfo loadingInfo {};
+                        loadingInfo.filesystem = filesystem;
+                        loadingInfo.path = dependency;
+                        loadImage(loadingInfo);
+                    }
+                    catch (...) {}
+                });
+            }
+        }
+
+        // Uncompressed archive entries are viewed directly, so latest version of file is never copied before staging
+        const bool isLatestVersion = MeshFormat::version(meshBytes->data(), meshBytes->size()) == MeshFormat::kLatestVersion;
+        MeshData meshData {};
+        MeshView meshView {};
+
+        if (isLatestVersion) {
+            meshView = MeshFormat::view(meshBytes->data(), meshBytes->size());
+        }
+
+        const auto hasLods = [](const std::vector<MeshData::SubMesh>& subMeshes) {
+            return std::any_of(subMeshes.begin(), subMeshes.end(), [](const MeshData::SubMesh& subMesh) { return !subMesh.lods.empty(); });
+        };
+
+        const bool buildMeshlets = loadingInfo.buildMeshlets && meshView.meshlets.empty();
+        const bool generateLods = loadingInfo.amountOfLods > 0 && !hasLods(meshView.subMeshes);
+
+        // Legacy files are interleaved, and processing modifies geometry, so in all these cases file must be parsed entirely
+        if (!isLatestVersion || loadingInfo.optimizeGeometry || loadingInfo.optimizeOverdraw || buildMeshlets || generateLods) {
+            meshData = MeshFormat::read(meshBytes->data(), meshBytes->size());
+
+            // Meshlets must be built first, because cache optimization is done per meshlet when they're present
+            if (loadingInfo.buildMeshlets && meshData.meshlets.empty()) {
+                MeshOptimizer::buildMeshlets(meshData);
+            }
+
+            // LODs are only index ranges, so they're also reordered by cache optimization below
+            if (loadingInfo.amountOfLods > 0 && !hasLods(meshData.subMeshes)) {
+                MeshOptimizer::generateLods(meshData, loadingInfo.amountOfLods);
+            }
+
+            if (loadingInfo.optimizeGeometry || loadingInfo.optimizeOverdraw) {
+                float acmrBefore = MeshOptimizer::computeAcmr(meshData);
+
+                // Overdraw optimization splits clusters by cache order, so triangles must be ordered for cache first in any case
+                MeshOptimizer::optimizeVertexCache(meshData);
+
+                if (loadingInfo.optimizeOverdraw) {
+                    MeshOptimizer::optimizeOverdraw(meshData);
+                }
+
+                MeshOptimizer::optimizeVertexFetch(meshData);
+
+                COFFEE_INFO("Optimized geometry of mesh '{}', ACMR {:.3f} -> {:.3f}.", id.path(), acmrBefore, MeshOptimizer::computeAcmr(meshData));
+            }
+
+            meshView = MeshFormat::view(meshData);
+        }
+
+        std::vector<std::string> texturePaths {};
+        texturePaths.reserve(meshView.subMeshes.size() * MeshData::kAmountOfTextures);
+
+        for (const auto& subMesh : meshView.subMeshes) {
+            for (const auto& texture : subMesh.textures) {
+                if (!texture.empty()) {
+                    texturePaths.push_back(texture);
+                }
+            }
+        }
+
+        // Most meshes reuse same textures across submeshes, so each unique texture must be loaded only once
+        std::sort(texturePaths.begin(), texturePaths.end());
+        texturePaths.erase(std::unique(texturePaths.begin(), texturePaths.end()), texturePaths.end());
+
+        // Decided at load time as well, so files that were packed with 32-bit indices are still getting smaller buffers
+        const uint32_t indexSize = MeshFormat::fitsShortIndices(meshView.subMeshes) ? sizeof(uint16_t) : sizeof(uint32_t);
+        const size_t amountOfIndices = meshView.indicesSize / meshView.indexSize;
+        const size_t indicesSize = amountOfIndices * indexSize;
+
+        const VertexFormat vertexFormat = loadingInfo.vertexFormat;
+        const size_t amountOfVertices = meshView.verticesSize / sizeof(Vertex);
+        const size_t verticesSize = amountOfVertices * vertexStride(vertexFormat);
+        const size_t positionsSize = loadingInfo.positionsStream ? amountOfVertices * positionStride(vertexFormat) : 0ULL;
+        // Odd amount of 16-bit indices would leave positions unaligned for writes from CPU
+        const size_t positionsOffset = (verticesSize + indicesSize + sizeof(float) - 1) & ~(sizeof(float) - 1);
+
+        BufferPtr verticesBuffer = nullptr;
+        BufferPtr indicesBuffer = nullptr;
+        BufferPtr positionsBuffer = nullptr;
+        std::vector<std::pair<BufferPtr, VkBufferCopy>> copyRegions {};
+        StagingRegion stagingRegion = stagingRing_->allocate(positionsOffset + positionsSize);
+        std::vector<ImageViewPtr> textures {};
+
+        tbb::task_group geometryStaging {};
+        geometryStaging.run([&]() {
+            BufferConfiguration verticesBufferConfiguration {};
+            verticesBufferConfiguration.instanceSize = vertexStride(vertexFormat);
+            verticesBufferConfiguration.instanceCount = static_cast<uint32_t>(amountOfVertices);
+            verticesBufferConfiguration.usageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+            verticesBufferConfiguration.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+            verticesBufferConfiguration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            verticesBuffer = Buffer::create(device_, verticesBufferConfiguration);
+
+            VkBufferCopy verticesCopyRegion {};
+            verticesCopyRegion.srcOffset = 0;
+            verticesCopyRegion.size = verticesSize;
+            copyRegions.push_back({ verticesBuffer, verticesCopyRegion });
+
+            // Mesh without indices is drawn with regular draw calls
+            if (indicesSize > 0) {
+                BufferConfiguration indicesBufferConfiguration {};
+                indicesBufferConfiguration.instanceSize = indexSize;
+                indicesBufferConfiguration.instanceCount = static_cast<uint32_t>(amountOfIndices);
+                indicesBufferConfiguration.usageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
+                indicesBufferConfiguration.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+                indicesBufferConfiguration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+                indicesBuffer = Buffer::create(device_, indicesBufferConfiguration);
+
+                VkBufferCopy indicesCopyRegion {};
+                indicesCopyRegion.srcOffset = verticesSize;
+                indicesCopyRegion.size = indicesSize;
+                copyRegions.push_back({ indicesBuffer, indicesCopyRegion });
+            }
+
+            if (positionsSize > 0) {
+                BufferConfiguration positionsBufferConfiguration {};
+                positionsBufferConfiguration.instanceSize = positionStride(vertexFormat);
+                positionsBufferConfiguration.instanceCount = static_cast<uint32_t>(amountOfVertices);
+                positionsBufferConfiguration.usageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+                positionsBufferConfiguration.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+                positionsBufferConfiguration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+                positionsBuffer = Buffer::create(device_, positionsBufferConfiguration);
+
+                VkBufferCopy positionsCopyRegion {};
+                positionsCopyRegion.srcOffset = positionsOffset;
+                positionsCopyRegion.size = positionsSize;
+                copyRegions.push_back({ positionsBuffer, positionsCopyRegion });
+            }
+
+            // Regions are contiguous in file, so full vertices are copied in bulk and only compact formats are converted one by one
+            MeshFormat::copyVertices(meshView, stagingRegion.memory, vertexFormat);
+            MeshFormat::copyIndices(meshView, stagingRegion.memory + verticesSize, indexSize);
+
+            if (positionsSize > 0) {
+                MeshFormat::copyPositions(meshView, stagingRegion.memory + positionsOffset, vertexFormat);
+            }
+
+            stagingRegion.flush();
+        });
+
+        if (!asyncTextures) {
+            // Prefetched textures must be finished by this task group, otherwise waiting for them in loadImage might never end
+            dependencyLoads.wait();
+
+            // Textures are decoded and uploaded while geometry is still written into staging memory
+            textures = loadTextures(filesystem, texturePaths);
+        }
+
+        geometryStaging.wait();
+
+        // Geometry is already in staging memory, so only submeshes and meshlets are required from view after this point
+        return MeshUpload {
+            filesystem,
+            id,
+            asyncTextures,
+            vertexFormat,
+            indexSize,
+            std::move(meshView.subMeshes),
+            std::move(meshView.meshlets),
+            std::move(verticesBuffer),
+            std::move(indicesBuffer),
+            std::move(positionsBuffer),
+            std::move(stagingRegion),
+            std::move(copyRegions),
+            std::move(texturePaths),
+            std::move(textures)
+        };
+    }
+
+    graphics::MeshPtr AssetManager::submitMeshUpload(MeshUpload&& upload)
+    {
+        using namespace graphics;
+
+        uploadBuffers(std::move(upload.stagingRegion), upload.copyRegions);
+
+        std::vector<SubMesh> subMeshes {};
+        subMeshes.reserve(upload.subMeshes.size());
+
+        for (const auto& subMeshData : upload.subMeshes) {
+            Materials materials { missingTexture_ };
+            materials.modifiers = subMeshData.modifiers;
+
+            AABB aabb {};
+            aabb.min = glm::vec4 { subMeshData.aabbMin, 1.0f };
+            aabb.max = glm::vec4 { subMeshData.aabbMax, 1.0f };
+
+            subMeshes.emplace_back(
+                std::move(materials),
+                std::move(aabb),
+                subMeshData.verticesOffset,
+                subMeshData.indicesOffset,
+                subMeshData.verticesCount,
+                subMeshData.indicesCount,
+                subMeshData.meshletsOffset,
+                subMeshData.meshletsCount,
+                std::vector<SubMeshLod> { subMeshData.lods }
+            );
+        }
+
+        auto mesh = std::make_shared<Mesh>(
+            std::move(subMeshes),
+            std::move(upload.verticesBuffer),
+            std::move(upload.indicesBuffer),
+            upload.indexSize == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32,
+            std::move(upload.meshlets),
+            upload.vertexFormat,
+            std::move(upload.positionsBuffer)
+        );
+        declareDependencies(upload.path, upload.texturePaths);
+
+        if (!upload.asyncTextures) {
+            writeTextures(mesh, upload.subMeshes, upload.texturePaths, upload.textures);
+            return mesh;
+        }
+
+        // Mesh is returned with placeholder textures, actual textures will be written when they're uploaded
+        backgroundTasks_.run([this,
+                              filesystem = std::move(upload.filesystem),
+                              weakMesh = std::weak_ptr<Mesh> { mesh },
+                              subMeshesData = std::move(upload.subMeshes),
+                              texturePaths = std::move(upload.texturePaths)]() {
+            try {
+                std::vector<ImageViewPtr> loadedTextures = loadTextures(filesystem, texturePaths);
+
+                if (auto lockedMesh = weakMesh.lock()) {
+                    writeTextures(lockedMesh, subMeshesData, texturePaths, loadedTextures);
+                }
+            }
+            catch (const std::exception& exception) {
+                COFFEE_ERROR("Failed to load textures of mesh asynchronously: {}", exception.what());
+            }
+        });
+
+        return mesh;
+    }
+
+    std::vector<graphics::ImageViewPtr> AssetManager::loadTextures(const FilesystemPtr& filesystem, const std::vector<std::string>& paths)
+    {
+        std::vector<graphics::ImageViewPtr> textures {};
+        textures.resize(paths.size());
+
+        tbb::parallel_for(size_t { 0 }, paths.size(), [&](size_t index) {
+            ImageLoadingInfo loadingInfo {};
+            loadingInfo.filesystem = filesystem;
+            loadingInfo.path = paths[index];
+
+            graphics::ImagePtr image = loadImage(loadingInfo);
+
+            graphics::ImageViewConfiguration viewConfiguration {};
+            viewConfiguration.viewType = VK_IMAGE_VIEW_TYPE_2D;
+            viewConfiguration.format = image->imageFormat;
+            viewConfiguration.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            viewConfiguration.subresourceRange.baseMipLevel = 0;
+            viewConfiguration.subresourceRange.levelCount = image->mipLevels;
+            viewConfiguration.subresourceRange.baseArrayLayer = 0;
+            viewConfiguration.subresourceRange.layerCount = image->arrayLayers;
+            textures[index] = graphics::ImageView::create(image, viewConfiguration);
+        });
+
+        return textures;
+    }
+
+    void AssetManager::writeTextures(
+        const graphics::MeshPtr& mesh,
+        const std::vector<MeshData::SubMesh>& subMeshesData,
+        const std::vector<std::string>& paths,
+        const std::vector<graphics::ImageViewPtr>& textures
+    )
+    {
+        for (size_t subMeshIndex = 0; subMeshIndex < subMeshesData.size(); subMeshIndex++) {
+            const auto& subMeshTextures = subMeshesData[subMeshIndex].textures;
+
+            for (size_t textureIndex = 0; textureIndex < subMeshTextures.size(); textureIndex++) {
+                if (subMeshTextures[textureIndex].empty()) {
+                    continue;
+                }
+
+                size_t pathIndex = std::lower_bound(paths.begin(), paths.end(), subMeshTextures[textureIndex]) - paths.begin();
+                mesh->subMeshes[subMeshIndex].materials.write(textures[pathIndex], static_cast<TextureType>(1U << textureIndex));
+            }
+        }
+    }
+
+    AssetManager::ImageUpload AssetManager::decodeImage(Filesystem::FileType type, std::vector<uint8_t>& rawBytes, bool generateMipmaps)
+    {
+        switch (type) {
+            case Filesystem::FileType::RawImage:
+                return decodeRawImage(rawBytes, generateMipmaps);
+            case Filesystem::FileType::BasisImage:
+                return decodeBasisImage(rawBytes);
+            default:
+                throw AssetException { AssetException::Type::TypeMismatch,
+                                       fmt::format("Expected type Image, requested type was {}", detail::fileTypeToString(type)) };
+        }
+    }
+
+    graphics::ImagePtr AssetManager::submitImageUpload(ImageUpload&& upload)
+    {
+        graphics::ImagePtr image = upload.image;
+
+        // Every level is transitioned into shader read-only layout here, including levels that will be streamed later
+        // This way views over whole mip chain are valid right away, and streamed levels are never moved out of undefined layout again
+        if (upload.generateMipmaps) {
+            uploadImageWithMipmaps(std::move(upload.stagingRegion), image, upload.copyRegions[0], upload.mipmapFilter);
+        }
+        else {
+            uploadImage(std::move(upload.stagingRegion), image, std::move(upload.copyRegions), 0U, image->mipLevels);
+        }
+
+        image->setResidentMipLevel(upload.residentMipLevel);
+
+        // Streaming must start only after initial upload was submitted, otherwise it's layout transition will discard streamed levels
+        if (upload.streamingImage != nullptr) {
+            transcodeStreamingLevel(std::move(upload.streamingImage));
+        }
+
+        return image;
+    }
+
+    AssetManager::ImageUpload AssetManager::decodeRawImage(std::vector<uint8_t>& rawBytes, bool generateMipmaps)
+    {
+        using namespace graphics;
+
+        utils::ReadOnlyStream<4> stream { rawBytes };
+        uint32_t width = stream.read<uint32_t>();
+        uint32_t height = stream.read<uint32_t>();
+        uint32_t amountOfChannels = stream.read<uint32_t>();
+
+        ImageConfiguration imageConfiguration {};
+        imageConfiguration.imageType = VK_IMAGE_TYPE_2D;
+        imageConfiguration.format = channelsToVkFormat(amountOfChannels, false);
+        imageConfiguration.extent = { width, height, 1U };
+        imageConfiguration.mipLevels = 1U;
+        imageConfiguration.arrayLayers = 1U;
+        imageConfiguration.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageConfiguration.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageConfiguration.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+        VkFilter mipmapFilter = VK_FILTER_LINEAR;
+        generateMipmaps = generateMipmaps && std::max(width, height) > 1;
+
+        if (generateMipmaps && !selectMipmapFilter(imageConfiguration.format, mipmapFilter)) {
+            COFFEE_WARNING(
+                "Format {} doesn't support blitting, image {}x{} will be loaded without mipmaps.",
+                static_cast<uint32_t>(imageConfiguration.format),
+                width,
+                height
+            );
+            generateMipmaps = false;
+        }
+
+        if (generateMipmaps) {
+            imageConfiguration.mipLevels = Math::indexOfHighestBit(std::max(width, height)) + 1U;
+            imageConfiguration.usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        }
+
+        auto image = Image::create(device_, imageConfiguration);
+
+        StagingRegion stagingRegion = stagingRing_->allocate(rawBytes.size() - stream.offset());
+        std::memcpy(stagingRegion.memory, rawBytes.data() + stream.offset(), rawBytes.size() - stream.offset());
+        stagingRegion.flush();
+
+        VkBufferImageCopy copyRegion {};
+        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copyRegion.imageSubresource.layerCount = 1;
+        copyRegion.imageExtent.width = image->extent.width;
+        copyRegion.imageExtent.height = image->extent.height;
+        copyRegion.imageExtent.depth = image->extent.depth;
+
+        return ImageUpload { std::move(image), std::move(stagingRegion), { copyRegion }, 0U, generateMipmaps, mipmapFilter, nullptr };
+    }
+
+    AssetManager::ImageUpload AssetManager::decodeBasisImage(std::vector<uint8_t>& rawBytes)
+    {
+        using namespace graphics;
+
+        auto transcoder = std::make_unique<basist::ktx2_transcoder>();
+
+        if (!transcoder->init(rawBytes.data(), rawBytes.size())) {
+            throw AssetException { AssetException::Type::ImplementationFailure, "Failed to begin transcoding process!" };
+        }
+
+        auto* amountOfChannelsInImage = transcoder->find_key(detail::kBasisChannelCountField);
+
+        if (amountOfChannelsInImage == nullptr || amountOfChannelsInImage->size() != sizeof(uint32_t)) {
+            throw AssetException { AssetException::Type::TypeMismatch, "Basis image doesn't contain required fields!" };
+        }
+
+        uint32_t amountOfChannels = 0;
+        std::memcpy(&amountOfChannels, amountOfChannelsInImage->data(), sizeof(uint32_t));
+
+        const VkFormat imageFormat = channelsToVkFormat(amountOfChannels, true);
+        const basist::transcoder_texture_format format = channelsToBasisuFormat(amountOfChannels);
+        const bool useTranscodeCache = !transcodeCachePath_.empty();
+        XXH64_hash_t contentHash = 0ULL;
+
+        if (useTranscodeCache) {
+            contentHash = XXH3_64bits(rawBytes.data(), rawBytes.size());
+
+            if (std::optional<ImageUpload> cachedImage = loadCachedBasisImage(contentHash, imageFormat, format); cachedImage.has_value()) {
+                return std::move(*cachedImage);
+            }
+        }
+
+        if (!transcoder->start_transcoding()) {
+            throw AssetException { AssetException::Type::ImplementationFailure, "Failed to begin transcoding process!" };
+        }
+
+        basist::ktx2_image_level_info levelInfo {};
+        uint32_t mipLevels = 1U;
+        uint32_t firstResidentLevel = 0U;
+
+        // Levels that are less than 64 pixels are never uploaded, they're too small to be useful
+        for (; mipLevels < transcoder->get_levels(); mipLevels++) {
+            transcoder->get_image_level_info(levelInfo, mipLevels, 0, 0);
+
+            if (levelInfo.m_width < 64 && levelInfo.m_height < 64) {
+                break;
+            }
+        }
+
+        // When streaming, only least detailed levels are uploaded right away, and others will be uploaded in update()
+        // Images that will be written into transcode cache are always transcoded fully, next launch will read them at once anyway
+        if (streamingBytesPerFrame_ > 0 && !useTranscodeCache) {
+            for (firstResidentLevel = mipLevels - 1; firstResidentLevel > 0; firstResidentLevel--) {
+                transcoder->get_image_level_info(levelInfo, firstResidentLevel - 1, 0, 0);
+
+                if (levelInfo.m_width > streamingInitialExtent_ || levelInfo.m_height > streamingInitialExtent_) {
+                    break;
+                }
+            }
+        }
+
+        transcoder->get_image_level_info(levelInfo, 0, 0, 0);
+
+        ImageConfiguration imageConfiguration {};
+        imageConfiguration.imageType = VK_IMAGE_TYPE_2D;
+        imageConfiguration.format = imageFormat;
+        imageConfiguration.extent = { levelInfo.m_orig_width, levelInfo.m_orig_height, 1U };
+        imageConfiguration.mipLevels = mipLevels;
+        imageConfiguration.arrayLayers = transcoder->get_faces();
+        imageConfiguration.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageConfiguration.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageConfiguration.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+        if (imageConfiguration.arrayLayers == 6) {
+            imageConfiguration.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
+        }
+
+        std::vector<VkBufferImageCopy> copyRegions {};
+        auto transcodedBytes = useTranscodeCache ? std::make_shared<std::vector<uint8_t>>() : nullptr;
+        StagingRegion stagingRegion =
+            transcodeBasisLevels(*transcoder, format, firstResidentLevel, mipLevels - firstResidentLevel, copyRegions, transcodedBytes.get());
+
+        auto image = Image::create(device_, imageConfiguration);
+
+        if (useTranscodeCache) {
+            // Compression and writing are slow enough to be moved out of loading path, copy regions doesn't have staging offset applied yet
+            backgroundTasks_.run([this, contentHash, imageConfiguration, copyRegions, transcodedBytes]() {
+                storeCachedBasisImage(contentHash, imageConfiguration, copyRegions, *transcodedBytes);
+            });
+        }
+
+        std::unique_ptr<StreamingImage> streamingImage = nullptr;
+
+        if (firstResidentLevel > 0) {
+            streamingImage = std::make_unique<StreamingImage>();
+            streamingImage->image = image;
+            // Moving vector keeps it's storage, so transcoder still references valid memory
+            streamingImage->rawBytes = std::move(rawBytes);
+            streamingImage->transcoder = std::move(transcoder);
+            streamingImage->format = format;
+            streamingImage->nextMipLevel = firstResidentLevel - 1;
+        }
+
+        return ImageUpload {
+            std::move(image), std::move(stagingRegion), std::move(copyRegions), firstResidentLevel, false, VK_FILTER_LINEAR, std::move(streamingImage)
+        };
+    }
+
+    graphics::StagingRegion AssetManager::transcodeBasisLevels(
+        basist::ktx2_transcoder& transcoder,
+        basist::transcoder_texture_format format,
+        uint32_t baseMipLevel,
+        uint32_t levelCount,
+        std::vector<VkBufferImageCopy>& copyRegions,
+        std::vector<uint8_t>* transcodedBytes
+    )
+    {
+        const size_t allocationSize = layoutBasisLevels(transcoder, format, baseMipLevel, levelCount, copyRegions);
+
+        // Transcoding directly into staging memory, so there no need for intermediate buffer
+        // Staging memory is write-combined, so if transcoded bytes will be read later they're transcoded into host memory first
+        graphics::StagingRegion stagingRegion = stagingRing_->allocate(allocationSize);
+
+        if (transcodedBytes != nullptr) {
+            transcodedBytes->resize(allocationSize);
+            transcodeBasisRegions(transcoder, format, copyRegions, transcodedBytes->data());
+            std::memcpy(stagingRegion.memory, transcodedBytes->data(), allocationSize);
+        }
+        else {
+            transcodeBasisRegions(transcoder, format, copyRegions, stagingRegion.memory);
+        }
+
+        stagingRegion.flush();
+
+        return stagingRegion;
+    }
+
+    size_t AssetManager::layoutBasisLevels(
+        const basist::ktx2_transcoder& transcoder,
+        basist::transcoder_texture_format format,
+        uint32_t baseMipLevel,
+        uint32_t levelCount,
+        std::vector<VkBufferImageCopy>& copyRegions
+    )
+    {
+        const uint32_t bytesPerBlock = basist::basis_get_bytes_per_block_or_pixel(format);
+        const bool isBlockFormat = !basist::basis_transcoder_format_is_uncompressed(format);
+        basist::ktx2_image_level_info levelInfo {};
+        size_t totalSize = 0ULL;
+
+        copyRegions.clear();
+        copyRegions.reserve(static_cast<size_t>(transcoder.get_faces()) * levelCount);
+
+        // Offsets are computed upfront, so every level can be transcoded into it's own part of memory independently
+        for (uint32_t mipLevel = baseMipLevel; mipLevel < baseMipLevel + levelCount; mipLevel++) {
+            for (uint32_t faceIndex = 0; faceIndex < transcoder.get_faces(); faceIndex++) {
+                transcoder.get_image_level_info(levelInfo, mipLevel, 0, faceIndex);
+
+                // Uncompressed formats expects size in pixels rather than in bytes
+                uint32_t blocksOrPixels =
+                    isBlockFormat ? levelInfo.m_num_blocks_x * levelInfo.m_num_blocks_y : levelInfo.m_orig_width * levelInfo.m_orig_height;
+
+                VkBufferImageCopy copyRegion {};
+                copyRegion.bufferOffset = totalSize;
+                copyRegion.bufferRowLength = 0;
+                copyRegion.bufferImageHeight = 0;
+                copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                copyRegion.imageSubresource.mipLevel = mipLevel;
+                copyRegion.imageSubresource.baseArrayLayer = faceIndex;
+                copyRegion.imageSubresource.layerCount = 1;
+                copyRegion.imageOffset = { 0, 0, 0 };
+                copyRegion.imageExtent = { levelInfo.m_orig_width, levelInfo.m_orig_height, 1U };
+                copyRegions.push_back(std::move(copyRegion));
+
+                totalSize += static_cast<size_t>(blocksOrPixels) * bytesPerBlock;
+            }
+        }
+
+        return totalSize;
+    }
+
+    void AssetManager::transcodeBasisRegions(
+        basist::ktx2_transcoder& transcoder,
+        basist::transcoder_texture_format format,
+        const std::vector<VkBufferImageCopy>& copyRegions,
+        uint8_t* output
+    )
+    {
+        ScopedLatency latency { stageLatency(AssetStatistics::Stage::Transcode) };
+
+        const bool isBlockFormat = !basist::basis_transcoder_format_is_uncompressed(format);
+
+        // Transcoder is thread-safe only when every thread provides it's own state
+        // State caches decompressed level data, so faces of same level are placed next to each other to reuse it
+        tbb::enumerable_thread_specific<basist::ktx2_transcoder_state> transcoderStates {};
+        std::atomic<bool> transcodingFailed { false };
+
+        tbb::parallel_for(size_t { 0 }, copyRegions.size(), [&](size_t index) {
+            const VkBufferImageCopy& copyRegion = copyRegions[index];
+            const VkExtent3D& extent = copyRegion.imageExtent;
+
+            // Transcoder always works with 4x4 blocks, same as get_image_level_info reports them
+            uint32_t blocksOrPixels = isBlockFormat ? ((extent.width + 3U) / 4U) * ((extent.height + 3U) / 4U) : extent.width * extent.height;
+
+            if (!transcoder.transcode_image_level(
+                    copyRegion.imageSubresource.mipLevel,
+                    0,
+                    copyRegion.imageSubresource.baseArrayLayer,
+                    output + copyRegion.bufferOffset,
+                    blocksOrPixels,
+                    format,
+                    0,
+                    0,
+                    0,
+                    -1,
+                    -1,
+                    &transcoderStates.local()
+                )) {
+                transcodingFailed.store(true, std::memory_order_relaxed);
+            }
+        });
+
+        if (transcodingFailed.load(std::memory_order_relaxed)) {
+            throw AssetException { AssetException::Type::ImplementationFailure, "Failed to transcode Basis image level!" };
+        }
+    }
+
+    std::string AssetManager::transcodeCacheFilename(XXH64_hash_t contentHash, VkFormat format) const
+    {
+        std::filesystem::path path = std::filesystem::path(transcodeCachePath_) /
+                                     fmt::format("{:016x}_{}_{}.ctc", contentHash, static_cast<uint32_t>(format), BASISD_LIB_VERSION);
+        return path.string();
+    }
+
+    std::optional<AssetManager::ImageUpload> AssetManager::loadCachedBasisImage(
+        XXH64_hash_t contentHash,
+        VkFormat imageFormat,
+        basist::transcoder_texture_format format
+    )
+    {
+        using namespace graphics;
+
+        std::string filename = transcodeCacheFilename(contentHash, imageFormat);
+        std::error_code ec {};
+
+        if (!std::filesystem::exists(filename, ec)) {
+            return std::nullopt;
+        }
+
+        mio::basic_mmap_source<uint8_t> cacheFile {};
+        cacheFile.map(filename, ec);
+
+        if (ec || cacheFile.size() < sizeof(detail::TranscodeCacheHeader)) {
+            return std::nullopt;
+        }
+
+        detail::TranscodeCacheHeader header {};
+        std::memcpy(&header, cacheFile.data(), sizeof(header));
+
+        const size_t regionsSize = static_cast<size_t>(header.amountOfRegions) * sizeof(detail::TranscodeCacheRegion);
+        const size_t payloadOffset = sizeof(header) + regionsSize;
+
+        // Cache is never trusted blindly, anything that doesn't match is simply transcoded again and overwritten
+        // Entries are always written with every level of every face, so region table must describe exactly that
+        const VkPhysicalDeviceLimits& limits = device_->properties().limits;
+        const uint32_t maxExtent = header.arrayLayers == 6 ? limits.maxImageDimensionCube : limits.maxImageDimension2D;
+        bool validHeader = header.magic == detail::kTranscodeCacheMagic && header.transcoderVersion == BASISD_LIB_VERSION &&
+                           header.contentHash == contentHash && header.format == static_cast<uint32_t>(imageFormat) && header.width > 0 &&
+                           header.height > 0 && header.width <= maxExtent && header.height <= maxExtent && header.mipLevels > 0 &&
+                           header.mipLevels <= Math::indexOfHighestBit(std::max(header.width, header.height)) + 1U &&
+                           (header.arrayLayers == 1 || (header.arrayLayers == 6 && header.width == header.height)) &&
+                           header.amountOfRegions == header.mipLevels * header.arrayLayers && payloadOffset <= cacheFile.size() &&
+                           header.compressedSize == cacheFile.size() - payloadOffset;
+
+        if (!validHeader) {
+            COFFEE_WARNING("Transcode cache entry '{}' is invalid and will be rebuilt.", filename);
+            return std::nullopt;
         }
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ASTC_4x4_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkThreeChannels = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
-            compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
-            return;
+        const uint32_t bytesPerBlock = basist::basis_get_bytes_per_block_or_pixel(format);
+        const bool isBlockFormat = !basist::basis_transcoder_format_is_uncompressed(format);
+        const uint32_t blockWidth = isBlockFormat ? basist::basis_get_block_width(format) : 1U;
+        const uint32_t blockHeight = isBlockFormat ? basist::basis_get_block_height(format) : 1U;
+        std::vector<VkBufferImageCopy> copyRegions {};
+        uint64_t expectedSize = 0ULL;
+        copyRegions.reserve(header.amountOfRegions);
+
+        for (uint32_t index = 0; index < header.amountOfRegions; index++) {
+            detail::TranscodeCacheRegion region {};
+            std::memcpy(&region, cacheFile.data() + sizeof(header) + index * sizeof(region), sizeof(region));
+
+            // Regions are written in the same order as transcodeBasisLevels produces them: faces of every level, packed back to back
+            const uint32_t mipLevel = index / header.arrayLayers;
+            const uint32_t levelWidth = std::max(header.width >> mipLevel, 1U);
+            const uint32_t levelHeight = std::max(header.height >> mipLevel, 1U);
+            const uint64_t regionSize = static_cast<uint64_t>((levelWidth + blockWidth - 1U) / blockWidth) *
+                                        ((levelHeight + blockHeight - 1U) / blockHeight) * bytesPerBlock;
+
+            bool validRegion = region.mipLevel == mipLevel && region.faceIndex == index % header.arrayLayers && region.width == levelWidth &&
+                               region.height == levelHeight && region.bufferOffset == expectedSize;
+
+            if (!validRegion) {
+                COFFEE_WARNING("Transcode cache entry '{}' has invalid region table and will be rebuilt.", filename);
+                return std::nullopt;
+            }
+
+            expectedSize += regionSize;
+
+            VkBufferImageCopy copyRegion {};
+            copyRegion.bufferOffset = region.bufferOffset;
+            copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            copyRegion.imageSubresource.mipLevel = region.mipLevel;
+            copyRegion.imageSubresource.baseArrayLayer = region.faceIndex;
+            copyRegion.imageSubresource.layerCount = 1;
+            copyRegion.imageOffset = { 0, 0, 0 };
+            copyRegion.imageExtent = { region.width, region.height, 1U };
+            copyRegions.push_back(std::move(copyRegion));
         }
 
-        // This must work properly because most GPU's doesn't support R8G8B8 (24 bits) because of misalignment
-        compressionTypes_.vkThreeChannels = VK_FORMAT_R8G8B8A8_UNORM;
-        compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFRGBA32;
-    }
+        if (header.uncompressedSize != expectedSize) {
+            COFFEE_WARNING("Transcode cache entry '{}' has invalid size and will be rebuilt.", filename);
+            return std::nullopt;
+        }
 
-    void AssetManager::selectFourChannels()
-    {
-        VkFormatProperties formatProperties;
+        // Decompressing directly into staging memory, ZSTD writes output sequentially so write-combined memory is fine here
+        StagingRegion stagingRegion = stagingRing_->allocate(header.uncompressedSize);
+        size_t result = 0ULL;
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_BC7_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkFourChannels = VK_FORMAT_BC7_UNORM_BLOCK;
-            compressionTypes_.basisFourChannels = basist::transcoder_texture_format::cTFBC7_RGBA;
-            return;
+        {
+            ScopedLatency latency { stageLatency(AssetStatistics::Stage::Decompress) };
+            result = ZSTD_decompress(stagingRegion.memory, header.uncompressedSize, cacheFile.data() + payloadOffset, header.compressedSize);
         }
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkFourChannels = VK_FORMAT_ETC2_R8G8B8A8_UNORM_BLOCK;
-            compressionTypes_.basisFourChannels = basist::transcoder_texture_format::cTFETC2_RGBA;
-            return;
+        if (ZSTD_isError(result) || result != header.uncompressedSize) {
+            COFFEE_WARNING("Transcode cache entry '{}' failed to decompress and will be rebuilt.", filename);
+            return std::nullopt;
         }
 
-        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), VK_FORMAT_ASTC_4x4_UNORM_BLOCK, &formatProperties);
-        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) {
-            compressionTypes_.vkFourChannels = VK_FORMAT_ASTC_4x4_UNORM_BLOCK;
-            compressionTypes_.basisFourChannels = basist::transcoder_texture_format::cTFASTC_4x4_RGBA;
-            return;
+        stagingRegion.flush();
+
+        ImageConfiguration imageConfiguration {};
+        imageConfiguration.imageType = VK_IMAGE_TYPE_2D;
+        imageConfiguration.format = imageFormat;
+        imageConfiguration.extent = { header.width, header.height, 1U };
+        imageConfiguration.mipLevels = header.mipLevels;
+        imageConfiguration.arrayLayers = header.arrayLayers;
+        imageConfiguration.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageConfiguration.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageConfiguration.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+        if (imageConfiguration.arrayLayers == 6) {
+            imageConfiguration.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
         }
 
-        compressionTypes_.vkFourChannels = VK_FORMAT_R8G8B8A8_UNORM;
-        compressionTypes_.basisThreeChannels = basist::transcoder_texture_format::cTFRGBA32;
+        auto image = Image::create(device_, imageConfiguration);
+
+        return ImageUpload { std::move(image), std::move(stagingRegion), std::move(copyRegions), 0U, false, VK_FILTER_LINEAR, nullptr };
     }
 
-    graphics::MeshPtr AssetManager::loadMesh(const FilesystemPtr& filesystem, const std::string& path)
+    void AssetManager::storeCachedBasisImage(
+        XXH64_hash_t contentHash,
+        const graphics::ImageConfiguration& imageConfiguration,
+        const std::vector<VkBufferImageCopy>& copyRegions,
+        const std::vector<uint8_t>& transcodedBytes
+    )
     {
-        using namespace graphics;
+        std::string filename = transcodeCacheFilename(contentHash, imageConfiguration.format);
 
-        constexpr uint8_t headerMagic[4] = { 0xF0, 0x7B, 0xAE, 0x31 };
-        constexpr uint8_t meshMagic[4] = { 0x13, 0xEA, 0xB7, 0xF0 };
+        std::vector<uint8_t> compressedBytes {};
+        compressedBytes.resize(ZSTD_compressBound(transcodedBytes.size()));
 
-        std::vector<uint8_t> meshStream = filesystem->getContent(path);
-        utils::ReaderStream stream { meshStream };
+        size_t compressedSize = ZSTD_compress(
+            compressedBytes.data(),
+            compressedBytes.size(),
+            transcodedBytes.data(),
+            transcodedBytes.size(),
+            detail::kTranscodeCacheCompressionLevel
+        );
 
-        if (stream.size() < 8) {
-            throw FilesystemException { FilesystemException::Type::InvalidFileType, "Invalid header size!" };
+        if (ZSTD_isError(compressedSize)) {
+            COFFEE_ERROR("Failed to compress transcode cache entry '{}': {}", filename, ZSTD_getErrorName(compressedSize));
+            return;
         }
 
-        if (std::memcmp(stream.readBuffer<uint8_t, 4>(), headerMagic, 4) != 0) {
-            throw FilesystemException { FilesystemException::Type::InvalidFileType, "Invalid header magic!" };
-        }
+        detail::TranscodeCacheHeader header {};
+        header.magic = detail::kTranscodeCacheMagic;
+        header.transcoderVersion = BASISD_LIB_VERSION;
+        header.contentHash = contentHash;
+        header.format = static_cast<uint32_t>(imageConfiguration.format);
+        header.width = imageConfiguration.extent.width;
+        header.height = imageConfiguration.extent.height;
+        header.mipLevels = imageConfiguration.mipLevels;
+        header.arrayLayers = imageConfiguration.arrayLayers;
+        header.amountOfRegions = static_cast<uint32_t>(copyRegions.size());
+        header.uncompressedSize = transcodedBytes.size();
+        header.compressedSize = compressedSize;
+
+        // Written into temporary file first, so other instances will never see partially written entry
+        // Cache directory might be shared between processes, so thread id alone isn't enough to keep names unique
+        thread_local std::mt19937_64 generator { (static_cast<uint64_t>(std::random_device {}()) << 32) ^
+                                                 static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) };
+        std::string temporaryFilename = fmt::format("{}.{:016x}.tmp", filename, generator());
 
-        uint32_t meshesSize = stream.read<uint32_t>();
+        {
+            std::ofstream file { temporaryFilename, std::ios::out | std::ios::binary | std::ios::trunc };
 
-        std::vector<Vertex> vertices {};
-        std::vector<uint32_t> indices {};
-        std::vector<MaterialMetadata> materialsMetadata {};
-        std::vector<MaterialMetadata> uploadsMetadata {};
-        std::vector<MeshMetadata> meshesMetadata {};
-        std::vector<Materials> materials {};
+            if (!file.is_open()) {
+                COFFEE_ERROR("Failed to open transcode cache entry '{}' for writing.", temporaryFilename);
+                return;
+            }
 
-        materialsMetadata.reserve(7ULL * meshesSize);
-        meshesMetadata.reserve(meshesSize);
-        materials.reserve(meshesSize);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
-        for (uint32_t i = 0; i < meshesSize; i++) {
-            if (std::memcmp(stream.readBuffer<uint8_t, 4>(), meshMagic, 4) != 0) {
-                throw FilesystemException { FilesystemException::Type::InvalidFileType, "Invalid mesh magic!" };
+            for (const auto& copyRegion : copyRegions) {
+                detail::TranscodeCacheRegion region {};
+                region.bufferOffset = copyRegion.bufferOffset;
+                region.mipLevel = copyRegion.imageSubresource.mipLevel;
+                region.faceIndex = copyRegion.imageSubresource.baseArrayLayer;
+                region.width = copyRegion.imageExtent.width;
+                region.height = copyRegion.imageExtent.height;
+                file.write(reinterpret_cast<const char*>(&region), sizeof(region));
             }
 
-            uint32_t verticesSize = stream.read<uint32_t>();
-            uint32_t indicesSize = stream.read<uint32_t>();
+            file.write(reinterpret_cast<const char*>(compressedBytes.data()), compressedSize);
 
-            glm::vec3 aabbMin {};
-            glm::vec3 aabbMax {};
-            stream.readDirectly(&aabbMin);
-            stream.readDirectly(&aabbMax);
+            if (!file.good()) {
+                COFFEE_ERROR("Failed to write transcode cache entry '{}'.", temporaryFilename);
+                file.close();
+                std::filesystem::remove(temporaryFilename);
+                return;
+            }
+        }
 
-            materials.push_back({ missingTexture_ });
-            stream.readDirectly(&materials[i].modifiers.diffuseColor);
-            stream.readDirectly(&materials[i].modifiers.specularColor);
-            stream.readDirectly(&materials[i].modifiers.metallicFactor);
-            stream.readDirectly(&materials[i].modifiers.roughnessFactor);
+        std::error_code ec {};
+        std::filesystem::rename(temporaryFilename, filename, ec);
 
-            materialsMetadata.push_back({ &materials[i], readMaterialName(stream), TextureType::Diffuse });
-            materialsMetadata.push_back({ &materials[i], readMaterialName(stream), TextureType::Specular });
-            materialsMetadata.push_back({ &materials[i], readMaterialName(stream), TextureType::Normals });
-            materialsMetadata.push_back({ &materials[i], readMaterialName(stream), TextureType::Emissive });
-            materialsMetadata.push_back({ &materials[i], readMaterialName(stream), TextureType::Roughness });
-            materialsMetadata.push_back({ &materials[i], readMaterialName(stream), TextureType::Metallic });
-            materialsMetadata.push_back({ &materials[i], readMaterialName(stream), TextureType::AmbientOcclusion });
+        if (ec) {
+            COFFEE_ERROR("Failed to move transcode cache entry '{}' with following message: {}", filename, ec.message());
+            std::filesystem::remove(temporaryFilename, ec);
+        }
+    }
 
-            uint32_t verticesOffset = static_cast<uint32_t>(vertices.size());
-            uint32_t indicesOffset = static_cast<uint32_t>(indices.size());
+    audio::BufferPtr AssetManager::loadWaveSound(const ByteBuffer& rawBytes)
+    {
+        constexpr size_t kChunkHeaderSize = 8;
 
-            vertices.resize(vertices.size() + verticesSize);
-            indices.resize(indices.size() + indicesSize);
-            stream.readDirectly(vertices.data() + verticesOffset, verticesSize);
-            stream.readDirectly(indices.data() + indicesOffset, indicesSize);
+        if (rawBytes.size() < 12 || std::memcmp(rawBytes.data(), "RIFF", 4) != 0 || std::memcmp(rawBytes.data() + 8, "WAVE", 4) != 0) {
+            throw AssetException { AssetException::Type::ImplementationFailure, "Provided sound doesn't have RIFF/WAVE header!" };
+        }
 
-            AABB aabb {};
-            aabb.min = glm::vec4 { aabbMin, 1.0f };
-            aabb.max = glm::vec4 { aabbMax, 1.0f };
-
-            meshesMetadata.push_back({ std::move(aabb), verticesOffset, verticesSize, indicesOffset, indicesSize });
-        }
-
-        size_t instanceCount = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t);
-        constexpr size_t instanceSize = sizeof(uint32_t);
-
-        BufferConfiguration stagingBufferConfiguration {};
-        stagingBufferConfiguration.instanceSize = instanceSize;
-        stagingBufferConfiguration.instanceCount = instanceCount / instanceSize;
-        stagingBufferConfiguration.usageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        stagingBufferConfiguration.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
-        stagingBufferConfiguration.allocationFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-        stagingBufferConfiguration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
-        auto stagingBuffer = Buffer::create(device_, stagingBufferConfiguration);
-
-        BufferConfiguration verticesBufferConfiguration {};
-        verticesBufferConfiguration.instanceSize = sizeof(Vertex);
-        verticesBufferConfiguration.instanceCount = vertices.size();
-        verticesBufferConfiguration.usageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-        verticesBufferConfiguration.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-        verticesBufferConfiguration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-        auto verticesBuffer = Buffer::create(device_, verticesBufferConfiguration);
-
-        BufferConfiguration indicesBufferConfiguration {};
-        indicesBufferConfiguration.instanceSize = sizeof(uint32_t);
-        indicesBufferConfiguration.instanceCount = indices.size();
-        indicesBufferConfiguration.usageFlags = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-        indicesBufferConfiguration.memoryProperties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-        indicesBufferConfiguration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-        auto indicesBuffer = Buffer::create(device_, indicesBufferConfiguration);
-
-        uint8_t* memory = static_cast<uint8_t*>(stagingBuffer->memory());
-        std::memcpy(memory, vertices.data(), vertices.size() * sizeof(Vertex));
-        std::memcpy(memory + vertices.size() * sizeof(Vertex), indices.data(), indices.size() * sizeof(uint32_t));
-        stagingBuffer->flush();
+        detail::WaveFormat format {};
+        const uint8_t* samples = nullptr;
+        size_t samplesSize = 0;
+        size_t offset = 12;
 
-        CommandBuffer transferCommandBuffer = CommandBuffer::createTransfer(device_);
+        while (offset + kChunkHeaderSize <= rawBytes.size()) {
+            const uint8_t* chunk = rawBytes.data() + offset;
+            size_t chunkSize = std::min<size_t>(detail::readLittleEndian<uint32_t>(chunk + 4), rawBytes.size() - offset - kChunkHeaderSize);
 
-        VkBufferCopy verticesCopyRegion {};
-        verticesCopyRegion.srcOffset = 0;
-        verticesCopyRegion.size = vertices.size() * sizeof(Vertex);
-        transferCommandBuffer.copyBuffer(stagingBuffer, verticesBuffer, 1, &verticesCopyRegion);
+            if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16) {
+                format.formatTag = detail::readLittleEndian<uint16_t>(chunk + 8);
+                format.channels = detail::readLittleEndian<uint16_t>(chunk + 10);
+                format.sampleRate = detail::readLittleEndian<uint32_t>(chunk + 12);
+                format.bitsPerSample = detail::readLittleEndian<uint16_t>(chunk + 22);
 
-        VkBufferCopy indicesCopyRegion {};
-        indicesCopyRegion.srcOffset = vertices.size() * sizeof(Vertex);
-        indicesCopyRegion.size = indices.size() * sizeof(uint32_t);
-        transferCommandBuffer.copyBuffer(stagingBuffer, indicesBuffer, 1, &indicesCopyRegion);
+                // Extensible format stores actual format in first two bytes of sub-format GUID
+                if (format.formatTag == detail::kWaveFormatExtensible && chunkSize >= 40) {
+                    format.formatTag = detail::readLittleEndian<uint16_t>(chunk + 32);
+                }
+            }
+            else if (std::memcmp(chunk, "data", 4) == 0) {
+                samples = chunk + kChunkHeaderSize;
+                samplesSize = chunkSize;
+            }
 
-        device_->submit(std::move(transferCommandBuffer), {}, nullptr, true);
+            // Chunks are always aligned to 2 bytes
+            offset += kChunkHeaderSize + chunkSize + (chunkSize & 1);
+        }
 
-        for (size_t index = 0; index < materialsMetadata.size(); index++) {
-            auto& metadata = materialsMetadata[index];
+        if (samples == nullptr || format.sampleRate == 0) {
+            throw AssetException { AssetException::Type::ImplementationFailure, "Provided sound doesn't have format or data chunk!" };
+        }
 
-            if (metadata.name.empty()) {
-                continue;
-            }
+        if (format.channels != 1 && format.channels != 2) {
+            throw AssetException { AssetException::Type::ImplementationFailure,
+                                   fmt::format("Only mono and stereo sounds are supported, provided sound has {} channels!", format.channels) };
+        }
 
-            HashAccessor accessor {};
-            XXH64_hash_t hash = XXH3_64bits(metadata.name.data(), metadata.name.size());
+        bool directlySupported = format.formatTag == detail::kWaveFormatPCM && (format.bitsPerSample == 8 || format.bitsPerSample == 16);
+        bool convertible = (format.formatTag == detail::kWaveFormatPCM && (format.bitsPerSample == 24 || format.bitsPerSample == 32)) ||
+                           (format.formatTag == detail::kWaveFormatIEEEFloat && format.bitsPerSample == 32);
 
-            if (cache_.find(accessor, hash)) {
-                auto& asset = accessor->second;
+        if (!directlySupported && !convertible) {
+            throw AssetException {
+                AssetException::Type::ImplementationFailure,
+                fmt::format("Unsupported sound format {} with {} bits per sample!", format.formatTag, format.bitsPerSample)
+            };
+        }
 
-                if (asset.type != Filesystem::FileType::RawImage) {
-                    throw AssetException { AssetException::Type::TypeMismatch,
-                                           fmt::format("Expected type Image, requested type was {}", detail::fileTypeToString(asset.type)) };
-                }
+        std::vector<uint8_t> convertedSamples {};
 
-                auto image = std::static_pointer_cast<graphics::Image>(asset.actualObject);
+        // OpenAL expects 16-bit samples in native endianness
+        if (convertible || (format.bitsPerSample == 16 && !Math::isSystemLittleEndian())) {
+            ScopedLatency latency { stageLatency(AssetStatistics::Stage::Transcode) };
 
-                graphics::ImageViewConfiguration viewConfiguration {};
-                viewConfiguration.viewType = VK_IMAGE_VIEW_TYPE_2D;
-                viewConfiguration.format = image->imageFormat;
-                viewConfiguration.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                viewConfiguration.subresourceRange.baseMipLevel = 0;
-                viewConfiguration.subresourceRange.levelCount = image->mipLevels;
-                viewConfiguration.subresourceRange.baseArrayLayer = 0;
-                viewConfiguration.subresourceRange.layerCount = image->arrayLayers;
+            convertedSamples = detail::convertToPCM16(format, samples, samplesSize);
+            format.bitsPerSample = 16;
+            samples = convertedSamples.data();
+            samplesSize = convertedSamples.size();
+        }
 
-                metadata.materials->write(graphics::ImageView::create(image, viewConfiguration), metadata.type);
-                continue;
-            }
+        audio::AudioFormat audioFormat = audio::AudioFormat::None;
 
-            Filesystem::Entry entry = filesystem->getMetadata(metadata.name);
-            std::vector<uint8_t> rawBytes = filesystem->getContent(metadata.name);
-            graphics::ImagePtr image = nullptr;
+        if (format.channels == 1) {
+            audioFormat = format.bitsPerSample == 8 ? audio::AudioFormat::Mono8Bit : audio::AudioFormat::Mono16Bit;
+        }
+        else {
+            audioFormat = format.bitsPerSample == 8 ? audio::AudioFormat::Stereo8Bit : audio::AudioFormat::Stereo16Bit;
+        }
 
-            switch (entry.type) {
-                case Filesystem::FileType::RawImage:
-                    image = loadRawImage(rawBytes);
-                    break;
-                case Filesystem::FileType::BasisImage:
-                    image = loadBasisImage(rawBytes);
-                    break;
-                default:
-                    COFFEE_ASSERT(false, "Should not happen.");
-                    break;
-            }
+        tbb::queuing_mutex::scoped_lock lock { audioMutex_ };
 
-            graphics::ImageViewConfiguration viewConfiguration {};
-            viewConfiguration.viewType = VK_IMAGE_VIEW_TYPE_2D;
-            viewConfiguration.format = image->imageFormat;
-            viewConfiguration.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            viewConfiguration.subresourceRange.baseMipLevel = 0;
-            viewConfiguration.subresourceRange.levelCount = image->mipLevels;
-            viewConfiguration.subresourceRange.baseArrayLayer = 0;
-            viewConfiguration.subresourceRange.layerCount = image->arrayLayers;
+        audio::BufferPtr sound = std::make_shared<audio::Buffer>(audio::Buffer::create());
+        sound->upload(audioFormat, samples, samplesSize, format.sampleRate);
+        return sound;
+    }
 
-            metadata.materials->write(graphics::ImageView::create(image, viewConfiguration), metadata.type);
-            cache_.insert(std::make_pair(hash, Asset::create(image)));
+    audio::BufferPtr AssetManager::loadOggSound(const ByteBuffer& rawBytes)
+    {
+        if (rawBytes.size() > static_cast<size_t>(INT_MAX)) {
+            throw AssetException { AssetException::Type::ImplementationFailure, "Provided sound is too big to be decoded!" };
         }
 
-        std::vector<SubMesh> subMeshes {};
-        subMeshes.reserve(meshesSize);
+        int amountOfChannels = 0;
+        int sampleRate = 0;
+        short* samples = nullptr;
+        int amountOfFrames = 0;
 
-        for (uint32_t i = 0; i < meshesSize; i++) {
-            subMeshes.emplace_back(
-                std::move(materials[i]),
-                std::move(meshesMetadata[i].aabb),
-                meshesMetadata[i].verticesOffset,
-                meshesMetadata[i].indicesOffset,
-                meshesMetadata[i].verticesSize,
-                meshesMetadata[i].indicesSize
-            );
+        {
+            ScopedLatency latency { stageLatency(AssetStatistics::Stage::Transcode) };
+
+            amountOfFrames = stb_vorbis_decode_memory(rawBytes.data(), static_cast<int>(rawBytes.size()), &amountOfChannels, &sampleRate, &samples);
         }
 
-        return std::make_shared<Mesh>(std::move(subMeshes), std::move(verticesBuffer), std::move(indicesBuffer));
-    }
+        // Samples are allocated by stb_vorbis itself with malloc
+        ScopeGuard samplesGuard { [samples]() { std::free(samples); } };
 
-    std::string AssetManager::readMaterialName(utils::ReaderStream& stream)
-    {
-        uint8_t size = stream.read<uint8_t>();
+        if (amountOfFrames < 0 || samples == nullptr) {
+            throw AssetException { AssetException::Type::ImplementationFailure, "Failed to decode Ogg Vorbis sound!" };
+        }
 
-        if (size == 0) {
-            return {};
+        if (amountOfChannels != 1 && amountOfChannels != 2) {
+            throw AssetException { AssetException::Type::ImplementationFailure,
+                                   fmt::format("Only mono and stereo sounds are supported, provided sound has {} channels!", amountOfChannels) };
         }
 
-        std::string outputString {};
-        outputString.resize(size);
+        audio::AudioFormat audioFormat = amountOfChannels == 1 ? audio::AudioFormat::Mono16Bit : audio::AudioFormat::Stereo16Bit;
+        const size_t samplesSize = static_cast<size_t>(amountOfFrames) * static_cast<size_t>(amountOfChannels) * sizeof(short);
 
-        stream.readDirectly(outputString.data(), size);
+        tbb::queuing_mutex::scoped_lock lock { audioMutex_ };
 
-        return outputString;
+        audio::BufferPtr sound = std::make_shared<audio::Buffer>(audio::Buffer::create());
+        sound->upload(audioFormat, samples, samplesSize, static_cast<uint32_t>(sampleRate));
+        return sound;
     }
 
-    graphics::ImagePtr AssetManager::loadRawImage(std::vector<uint8_t>& rawBytes)
+    void AssetManager::uploadImage(
+        graphics::StagingRegion&& stagingRegion,
+        const graphics::ImagePtr& image,
+        std::vector<VkBufferImageCopy>&& copyRegions,
+        uint32_t baseMipLevel,
+        uint32_t levelCount
+    )
     {
         using namespace graphics;
 
-        utils::ReadOnlyStream<4> stream { rawBytes };
-        uint32_t width = stream.read<uint32_t>();
-        uint32_t height = stream.read<uint32_t>();
-        uint32_t amountOfChannels = stream.read<uint32_t>();
-
-        ImageConfiguration imageConfiguration {};
-        imageConfiguration.imageType = VK_IMAGE_TYPE_2D;
-        imageConfiguration.format = channelsToVkFormat(amountOfChannels, false);
-        imageConfiguration.extent = { width, height, 1U };
-        imageConfiguration.mipLevels = 1U;
-        imageConfiguration.arrayLayers = 1U;
-        imageConfiguration.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageConfiguration.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imageConfiguration.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
-        auto image = Image::create(device_, imageConfiguration);
-
-        BufferConfiguration stagingBufferConfiguration {};
-        stagingBufferConfiguration.instanceSize = amountOfChannels;
-        stagingBufferConfiguration.instanceCount = width * height;
-        stagingBufferConfiguration.usageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        stagingBufferConfiguration.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
-        stagingBufferConfiguration.allocationFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-        stagingBufferConfiguration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
-        auto stagingBuffer = Buffer::create(device_, stagingBufferConfiguration);
+        ScopedLatency latency { stageLatency(AssetStatistics::Stage::Staging) };
 
-        std::memcpy(stagingBuffer->memory(), rawBytes.data() + stream.offset(), rawBytes.size() - stream.offset());
-        stagingBuffer->flush(rawBytes.size() - stream.offset());
+        const bool isUnifiedQueue = device_->isUnifiedGraphicsTransferQueue();
 
         CommandBuffer transferCommandBuffer = CommandBuffer::createTransfer(device_);
         VkImageMemoryBarrier barrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
-        VkBufferImageCopy copyRegion {};
 
         barrier.srcAccessMask = 0;
         barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -697,166 +2794,174 @@ namespace coffee {
         barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         barrier.image = image->image();
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.layerCount = 1;
+        barrier.subresourceRange.baseMipLevel = baseMipLevel;
+        barrier.subresourceRange.levelCount = levelCount;
+        barrier.subresourceRange.layerCount = image->arrayLayers;
         transferCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier);
 
-        copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        copyRegion.imageSubresource.layerCount = 1;
-        copyRegion.imageExtent.width = image->extent.width;
-        copyRegion.imageExtent.height = image->extent.height;
-        copyRegion.imageExtent.depth = image->extent.depth;
-        transferCommandBuffer.copyBufferToImage(stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+        for (auto& copyRegion : copyRegions) {
+            copyRegion.bufferOffset += stagingRegion.offset;
+        }
+
+        transferCommandBuffer.copyBufferToImage(
+            stagingRegion.buffer,
+            image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            copyRegions.size(),
+            copyRegions.data()
+        );
 
         barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = device_->isUnifiedGraphicsTransferQueue() ? VK_ACCESS_SHADER_READ_BIT : static_cast<VkAccessFlags>(0);
+        barrier.dstAccessMask = isUnifiedQueue ? VK_ACCESS_SHADER_READ_BIT : static_cast<VkAccessFlags>(0);
         barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
         barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
         barrier.srcQueueFamilyIndex = device_->transferQueueFamilyIndex();
         barrier.dstQueueFamilyIndex = device_->graphicsQueueFamilyIndex();
-        barrier.image = image->image();
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.layerCount = 1;
-        VkPipelineStageFlagBits useStage =
-            device_->isUnifiedGraphicsTransferQueue() ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-
+        VkPipelineStageFlagBits useStage = isUnifiedQueue ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
         transferCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, useStage, 0, 1, &barrier);
-        device_->submit(std::move(transferCommandBuffer), {}, nullptr, true);
-
-        if (!device_->isUnifiedGraphicsTransferQueue()) {
-            CommandBuffer ownershipCommandBuffer = CommandBuffer::createGraphics(device_);
 
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            barrier.srcQueueFamilyIndex = device_->transferQueueFamilyIndex();
-            barrier.dstQueueFamilyIndex = device_->graphicsQueueFamilyIndex();
-            barrier.image = image->image();
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.subresourceRange.levelCount = 1;
-            barrier.subresourceRange.layerCount = 1;
+        // Image must outlive copy even if user drops it right away
+        stagingRegion.keepAlive(image);
 
-            ownershipCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &barrier);
-            device_->submit(std::move(ownershipCommandBuffer), {}, nullptr, true);
+        if (isUnifiedQueue) {
+            stagingRegion.submit(std::move(transferCommandBuffer));
+            return;
         }
 
-        return image;
+        // Graphics queue must acquire ownership after copy is done, semaphore guarantees ordering without waiting on CPU
+        SemaphorePtr transferSemaphore = Semaphore::create(device_);
+        stagingRegion.keepAlive(transferSemaphore);
+
+        SubmitSemaphores transferSemaphores {};
+        transferSemaphores.signalSemaphores.push_back(transferSemaphore);
+        device_->submit(std::move(transferCommandBuffer), transferSemaphores);
+
+        CommandBuffer ownershipCommandBuffer = CommandBuffer::createGraphics(device_);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        ownershipCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &barrier);
+
+        SubmitSemaphores ownershipSemaphores {};
+        ownershipSemaphores.waitSemaphores.push_back(transferSemaphore);
+        ownershipSemaphores.waitDstStageMasks.push_back(VK_PIPELINE_STAGE_TRANSFER_BIT);
+        stagingRegion.submit(std::move(ownershipCommandBuffer), ownershipSemaphores);
     }
 
-    graphics::ImagePtr AssetManager::loadBasisImage(std::vector<uint8_t>& rawBytes)
+    void AssetManager::uploadStreamedLevel(
+        graphics::StagingRegion&& stagingRegion,
+        const graphics::ImagePtr& image,
+        std::vector<VkBufferImageCopy>&& copyRegions,
+        uint32_t mipLevel
+    )
     {
         using namespace graphics;
 
-        basist::ktx2_transcoder transcoder {};
-
-        if (!transcoder.init(rawBytes.data(), rawBytes.size())) {
-            throw AssetException { AssetException::Type::ImplementationFailure, "Failed to begin transcoding process!" };
-        }
-
-        auto* amountOfChannelsInImage = transcoder.find_key(detail::kBasisChannelCountField);
+        ScopedLatency latency { stageLatency(AssetStatistics::Stage::Staging) };
 
-        if (amountOfChannelsInImage == nullptr || amountOfChannelsInImage->size() != sizeof(uint32_t)) {
-            throw AssetException { AssetException::Type::TypeMismatch, "Basis image doesn't contain required fields!" };
-        }
+        const bool isUnifiedQueue = device_->isUnifiedGraphicsTransferQueue();
 
-        uint32_t amountOfChannels = 0;
-        std::memcpy(&amountOfChannels, amountOfChannelsInImage->data(), sizeof(uint32_t));
+        // Level is covered by views that frames in flight are sampling, so it's never discarded and always returns to shader read-only layout
+        // Barriers are ordered after previously submitted frames on graphics queue, and frames submitted later are ordered after them
+        VkImageMemoryBarrier barrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = isUnifiedQueue ? VK_ACCESS_TRANSFER_WRITE_BIT : static_cast<VkAccessFlags>(0);
+        barrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = device_->graphicsQueueFamilyIndex();
+        barrier.dstQueueFamilyIndex = device_->transferQueueFamilyIndex();
+        barrier.image = image->image();
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.baseMipLevel = mipLevel;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = image->arrayLayers;
 
-        if (!transcoder.start_transcoding()) {
-            throw AssetException { AssetException::Type::ImplementationFailure, "Failed to begin transcoding process!" };
-        }
+        SemaphorePtr releaseSemaphore = nullptr;
 
-        const basist::transcoder_texture_format format = channelsToBasisuFormat(amountOfChannels);
-        const uint32_t bytesPerBlock = basist::basis_get_bytes_per_block_or_pixel(format);
-        const bool isBlockFormat = !basist::basis_transcoder_format_is_uncompressed(format);
-        basist::ktx2_image_level_info levelInfo {};
-        size_t allocationSize = 0ULL;
+        if (!isUnifiedQueue) {
+            // Graphics queue owns image after initial upload, so it must release level once every previous frame is done with it
+            CommandBuffer releaseCommandBuffer = CommandBuffer::createGraphics(device_);
+            releaseCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 1, &barrier);
 
-        for (uint32_t faceIndex = 0; faceIndex < transcoder.get_faces(); faceIndex++) {
-            for (uint32_t mipmapLevel = 0; mipmapLevel < transcoder.get_levels(); mipmapLevel++) {
-                transcoder.get_image_level_info(levelInfo, mipmapLevel, 0, faceIndex);
+            releaseSemaphore = Semaphore::create(device_);
+            stagingRegion.keepAlive(releaseSemaphore);
 
-                if (levelInfo.m_width < 64 && levelInfo.m_height < 64) {
-                    continue;
-                }
+            SubmitSemaphores releaseSemaphores {};
+            releaseSemaphores.signalSemaphores.push_back(releaseSemaphore);
+            device_->submit(std::move(releaseCommandBuffer), releaseSemaphores);
 
-                allocationSize += isBlockFormat ? static_cast<size_t>(levelInfo.m_num_blocks_x) * levelInfo.m_num_blocks_y * bytesPerBlock
-                                                : static_cast<size_t>(levelInfo.m_width) * levelInfo.m_height;
-            }
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
         }
 
-        std::unique_ptr<uint8_t[]> imageBuffer = std::make_unique<uint8_t[]>(allocationSize);
-        std::vector<std::vector<MipmapInformation>> mipmapInformations {};
-        uint32_t width = 0;
-        uint32_t height = 0;
-        size_t offset = 0ULL;
-
-        for (uint32_t faceIndex = 0; faceIndex < transcoder.get_faces(); faceIndex++) {
-            mipmapInformations.emplace_back();
+        CommandBuffer transferCommandBuffer = CommandBuffer::createTransfer(device_);
+        VkPipelineStageFlagBits waitStage = isUnifiedQueue ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        transferCommandBuffer.imagePipelineBarrier(waitStage, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier);
 
-            for (uint32_t mipmapLevel = 0; mipmapLevel < transcoder.get_levels(); mipmapLevel++) {
-                transcoder.get_image_level_info(levelInfo, mipmapLevel, 0, faceIndex);
+        for (auto& copyRegion : copyRegions) {
+            copyRegion.bufferOffset += stagingRegion.offset;
+        }
 
-                if (levelInfo.m_width < 64 && levelInfo.m_height < 64) {
-                    continue;
-                }
+        transferCommandBuffer.copyBufferToImage(
+            stagingRegion.buffer,
+            image,
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            copyRegions.size(),
+            copyRegions.data()
+        );
 
-                uint32_t mipmapSize =
-                    isBlockFormat ? levelInfo.m_num_blocks_x * levelInfo.m_num_blocks_y * bytesPerBlock : levelInfo.m_width * levelInfo.m_height;
-                transcoder.transcode_image_level(mipmapLevel, 0, faceIndex, imageBuffer.get() + offset, mipmapSize, format);
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = isUnifiedQueue ? VK_ACCESS_SHADER_READ_BIT : static_cast<VkAccessFlags>(0);
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.srcQueueFamilyIndex = device_->transferQueueFamilyIndex();
+        barrier.dstQueueFamilyIndex = device_->graphicsQueueFamilyIndex();
+        VkPipelineStageFlagBits useStage = isUnifiedQueue ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        transferCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, useStage, 0, 1, &barrier);
 
-                MipmapInformation info {};
-                info.bufferOffset = offset;
-                info.width = levelInfo.m_width;
-                info.height = levelInfo.m_height;
-                mipmapInformations.back().push_back(std::move(info));
+        stagingRegion.keepAlive(image);
 
-                offset += mipmapSize;
-                width = std::max(width, levelInfo.m_width);
-                height = std::max(height, levelInfo.m_height);
-            }
+        if (isUnifiedQueue) {
+            stagingRegion.submit(std::move(transferCommandBuffer));
+            return;
         }
 
-        size_t instanceSize = 2;
-        while (allocationSize % instanceSize != 0) {
-            instanceSize++;
-        }
+        SemaphorePtr transferSemaphore = Semaphore::create(device_);
+        stagingRegion.keepAlive(transferSemaphore);
 
-        BufferConfiguration stagingBufferConfiguration {};
-        stagingBufferConfiguration.instanceSize = instanceSize;
-        stagingBufferConfiguration.instanceCount = allocationSize / instanceSize;
-        stagingBufferConfiguration.usageFlags = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-        stagingBufferConfiguration.memoryProperties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
-        stagingBufferConfiguration.allocationFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
-        stagingBufferConfiguration.allocationUsage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
-        auto stagingBuffer = Buffer::create(device_, stagingBufferConfiguration);
+        SubmitSemaphores transferSemaphores {};
+        transferSemaphores.waitSemaphores.push_back(releaseSemaphore);
+        transferSemaphores.waitDstStageMasks.push_back(VK_PIPELINE_STAGE_TRANSFER_BIT);
+        transferSemaphores.signalSemaphores.push_back(transferSemaphore);
+        device_->submit(std::move(transferCommandBuffer), transferSemaphores);
 
-        std::memcpy(stagingBuffer->memory(), imageBuffer.get(), allocationSize);
-        stagingBuffer->flush();
+        // Acquire is submitted right away, so frames submitted after update() will sample this level only after it's copied
+        CommandBuffer ownershipCommandBuffer = CommandBuffer::createGraphics(device_);
 
-        ImageConfiguration imageConfiguration {};
-        imageConfiguration.imageType = VK_IMAGE_TYPE_2D;
-        imageConfiguration.format = channelsToVkFormat(amountOfChannels, true);
-        imageConfiguration.extent = { width, height, 1U };
-        imageConfiguration.mipLevels = static_cast<uint32_t>(mipmapInformations[0].size());
-        imageConfiguration.arrayLayers = static_cast<uint32_t>(mipmapInformations.size());
-        imageConfiguration.samples = VK_SAMPLE_COUNT_1_BIT;
-        imageConfiguration.tiling = VK_IMAGE_TILING_OPTIMAL;
-        imageConfiguration.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        ownershipCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &barrier);
 
-        if (imageConfiguration.arrayLayers == 6) {
-            imageConfiguration.flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
-        }
+        SubmitSemaphores ownershipSemaphores {};
+        ownershipSemaphores.waitSemaphores.push_back(transferSemaphore);
+        ownershipSemaphores.waitDstStageMasks.push_back(VK_PIPELINE_STAGE_TRANSFER_BIT);
+        stagingRegion.submit(std::move(ownershipCommandBuffer), ownershipSemaphores);
+    }
 
-        auto image = Image::create(device_, imageConfiguration);
+    void AssetManager::uploadImageWithMipmaps(
+        graphics::StagingRegion&& stagingRegion,
+        const graphics::ImagePtr& image,
+        const VkBufferImageCopy& copyRegion,
+        VkFilter filter
+    )
+    {
+        using namespace graphics;
 
-        std::vector<VkBufferImageCopy> copyRegions {};
-        VkImageMemoryBarrier barrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+        ScopedLatency latency { stageLatency(AssetStatistics::Stage::Staging) };
+
+        const bool isUnifiedQueue = device_->isUnifiedGraphicsTransferQueue();
 
         CommandBuffer transferCommandBuffer = CommandBuffer::createTransfer(device_);
-        copyRegions.reserve(mipmapInformations[0].size() * mipmapInformations.size());
+        VkImageMemoryBarrier barrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
 
         barrier.srcAccessMask = 0;
         barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
@@ -866,68 +2971,186 @@ namespace coffee {
         barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         barrier.image = image->image();
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.levelCount = static_cast<uint32_t>(mipmapInformations[0].size());
-        barrier.subresourceRange.layerCount = static_cast<uint32_t>(mipmapInformations.size());
+        barrier.subresourceRange.levelCount = image->mipLevels;
+        barrier.subresourceRange.layerCount = image->arrayLayers;
         transferCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier);
 
-        for (size_t faceIndex = 0; faceIndex < mipmapInformations.size(); faceIndex++) {
-            auto& face = mipmapInformations[faceIndex];
+        VkBufferImageCopy offsetCopyRegion = copyRegion;
+        offsetCopyRegion.bufferOffset += stagingRegion.offset;
+        transferCommandBuffer.copyBufferToImage(stagingRegion.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &offsetCopyRegion);
 
-            for (size_t mipmapLevel = 0; mipmapLevel < face.size(); mipmapLevel++) {
-                auto& mipmap = face[mipmapLevel];
-
-                VkBufferImageCopy copyRegion {};
-                copyRegion.bufferOffset = mipmap.bufferOffset;
-                copyRegion.bufferRowLength = 0;
-                copyRegion.bufferImageHeight = 0;
-                copyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                copyRegion.imageSubresource.mipLevel = mipmapLevel;
-                copyRegion.imageSubresource.baseArrayLayer = faceIndex;
-                copyRegion.imageSubresource.layerCount = 1;
-                copyRegion.imageOffset = { 0, 0, 0 };
-                copyRegion.imageExtent = { mipmap.width, mipmap.height, 1U };
+        stagingRegion.keepAlive(image);
 
-                copyRegions.push_back(std::move(copyRegion));
-            }
+        // Unified queue is graphics queue itself, so blits can be recorded right after copy
+        if (isUnifiedQueue) {
+            recordMipmapsGeneration(transferCommandBuffer, image, filter);
+            stagingRegion.submit(std::move(transferCommandBuffer));
+            return;
         }
 
-        transferCommandBuffer.copyBufferToImage(stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, copyRegions.size(), copyRegions.data());
-
+        // Dedicated transfer queue doesn't support blits, so whole image is given to graphics queue in transfer layout
         barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = device_->isUnifiedGraphicsTransferQueue() ? VK_ACCESS_SHADER_READ_BIT : static_cast<VkAccessFlags>(0);
+        barrier.dstAccessMask = 0;
         barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
         barrier.srcQueueFamilyIndex = device_->transferQueueFamilyIndex();
         barrier.dstQueueFamilyIndex = device_->graphicsQueueFamilyIndex();
+        transferCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 1, &barrier);
+
+        SemaphorePtr transferSemaphore = Semaphore::create(device_);
+        stagingRegion.keepAlive(transferSemaphore);
+
+        SubmitSemaphores transferSemaphores {};
+        transferSemaphores.signalSemaphores.push_back(transferSemaphore);
+        device_->submit(std::move(transferCommandBuffer), transferSemaphores);
+
+        CommandBuffer graphicsCommandBuffer = CommandBuffer::createGraphics(device_);
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        graphicsCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier);
+        recordMipmapsGeneration(graphicsCommandBuffer, image, filter);
+
+        SubmitSemaphores graphicsSemaphores {};
+        graphicsSemaphores.waitSemaphores.push_back(transferSemaphore);
+        graphicsSemaphores.waitDstStageMasks.push_back(VK_PIPELINE_STAGE_TRANSFER_BIT);
+        stagingRegion.submit(std::move(graphicsCommandBuffer), graphicsSemaphores);
+    }
+
+    void AssetManager::recordMipmapsGeneration(const graphics::CommandBuffer& commandBuffer, const graphics::ImagePtr& image, VkFilter filter)
+    {
+        // Expects every level of image to be in TRANSFER_DST layout with first level already written
+        // Each level is blitted from previous one, which is transitioned into TRANSFER_SRC right before
+        VkImageMemoryBarrier barrier { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
         barrier.image = image->image();
         barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.levelCount = static_cast<uint32_t>(mipmapInformations[0].size());
-        barrier.subresourceRange.layerCount = static_cast<uint32_t>(mipmapInformations.size());
-        VkPipelineStageFlagBits useStage =
-            device_->isUnifiedGraphicsTransferQueue() ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-
-        transferCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, useStage, 0, 1, &barrier);
-        device_->submit(std::move(transferCommandBuffer), {}, nullptr, true);
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = image->arrayLayers;
 
-        if (!device_->isUnifiedGraphicsTransferQueue()) {
-            CommandBuffer ownershipCommandBuffer = CommandBuffer::createGraphics(device_);
+        int32_t width = static_cast<int32_t>(image->extent.width);
+        int32_t height = static_cast<int32_t>(image->extent.height);
 
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        for (uint32_t mipLevel = 1; mipLevel < image->mipLevels; mipLevel++) {
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
             barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-            barrier.srcQueueFamilyIndex = device_->transferQueueFamilyIndex();
-            barrier.dstQueueFamilyIndex = device_->graphicsQueueFamilyIndex();
-            barrier.image = image->image();
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.subresourceRange.levelCount = static_cast<uint32_t>(mipmapInformations[0].size());
-            barrier.subresourceRange.layerCount = static_cast<uint32_t>(mipmapInformations.size());
+            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.subresourceRange.baseMipLevel = mipLevel - 1;
+            commandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier);
+
+            int32_t nextWidth = std::max(width / 2, 1);
+            int32_t nextHeight = std::max(height / 2, 1);
+
+            VkImageBlit blitRegion {};
+            blitRegion.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blitRegion.srcSubresource.mipLevel = mipLevel - 1;
+            blitRegion.srcSubresource.layerCount = image->arrayLayers;
+            blitRegion.srcOffsets[1] = { width, height, 1 };
+            blitRegion.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            blitRegion.dstSubresource.mipLevel = mipLevel;
+            blitRegion.dstSubresource.layerCount = image->arrayLayers;
+            blitRegion.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+            commandBuffer.blitImage(
+                image,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                image,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                1,
+                &blitRegion,
+                filter
+            );
 
-            ownershipCommandBuffer.imagePipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 1, &barrier);
-            device_->submit(std::move(ownershipCommandBuffer), {}, nullptr, true);
+            width = nextWidth;
+            height = nextHeight;
         }
 
-        return image;
+        std::array<VkImageMemoryBarrier, 2> finalBarriers { barrier, barrier };
+
+        // Every level except last one was used as blit source
+        finalBarriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+        finalBarriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        finalBarriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        finalBarriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        finalBarriers[0].subresourceRange.baseMipLevel = 0;
+        finalBarriers[0].subresourceRange.levelCount = image->mipLevels - 1;
+
+        finalBarriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        finalBarriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        finalBarriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        finalBarriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        finalBarriers[1].subresourceRange.baseMipLevel = image->mipLevels - 1;
+        finalBarriers[1].subresourceRange.levelCount = 1;
+
+        commandBuffer.imagePipelineBarrier(
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0,
+            finalBarriers.size(),
+            finalBarriers.data()
+        );
+    }
+
+    bool AssetManager::selectMipmapFilter(VkFormat format, VkFilter& filter)
+    {
+        VkFormatProperties formatProperties {};
+        vkGetPhysicalDeviceFormatProperties(device_->physicalDevice(), format, &formatProperties);
+
+        constexpr VkFormatFeatureFlags kBlitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+
+        if ((formatProperties.optimalTilingFeatures & kBlitFeatures) != kBlitFeatures) {
+            return false;
+        }
+
+        // Nearest filter is still better than no mipmaps at all
+        bool supportsLinear = formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+        filter = supportsLinear ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+        return true;
+    }
+
+    void AssetManager::uploadBuffers(
+        graphics::StagingRegion&& stagingRegion,
+        const std::vector<std::pair<graphics::BufferPtr, VkBufferCopy>>& copyRegions
+    )
+    {
+        using namespace graphics;
+
+        ScopedLatency latency { stageLatency(AssetStatistics::Stage::Staging) };
+
+        CommandBuffer transferCommandBuffer = CommandBuffer::createTransfer(device_);
+
+        for (const auto& [buffer, copyRegion] : copyRegions) {
+            VkBufferCopy offsetCopyRegion = copyRegion;
+            offsetCopyRegion.srcOffset += stagingRegion.offset;
+
+            transferCommandBuffer.copyBuffer(stagingRegion.buffer, buffer, 1, &offsetCopyRegion);
+            stagingRegion.keepAlive(buffer);
+        }
+
+        // Buffers are created with concurrent sharing mode, so only visibility for vertex input is required
+        if (device_->isUnifiedGraphicsTransferQueue()) {
+            VkMemoryBarrier barrier { VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+            transferCommandBuffer.memoryPipelineBarrier(VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier);
+
+            stagingRegion.submit(std::move(transferCommandBuffer));
+            return;
+        }
+
+        SemaphorePtr transferSemaphore = Semaphore::create(device_);
+        stagingRegion.keepAlive(transferSemaphore);
+
+        SubmitSemaphores transferSemaphores {};
+        transferSemaphores.signalSemaphores.push_back(transferSemaphore);
+        device_->submit(std::move(transferCommandBuffer), transferSemaphores);
+
+        // Empty submit that makes every following graphics submit wait for copy
+        SubmitSemaphores graphicsSemaphores {};
+        graphicsSemaphores.waitSemaphores.push_back(transferSemaphore);
+        graphicsSemaphores.waitDstStageMasks.push_back(VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+        stagingRegion.submit(CommandBuffer::createGraphics(device_), graphicsSemaphores);
     }
 
     VkFormat AssetManager::channelsToVkFormat(uint32_t amountOfChannels, bool compressed)
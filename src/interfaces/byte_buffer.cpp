@@ -0,0 +1,17 @@
+#include <coffee/interfaces/byte_buffer.hpp>
+
+namespace coffee {
+
+    ByteBuffer::ByteBuffer(std::vector<uint8_t>&& bytes) noexcept
+        : storage_ { std::move(bytes) }
+        , data_ { storage_.data() }
+        , size_ { storage_.size() }
+    {}
+
+    ByteBuffer::ByteBuffer(const uint8_t* data, size_t size, std::shared_ptr<const void> owner) noexcept
+        : owner_ { std::move(owner) }
+        , data_ { data }
+        , size_ { size }
+    {}
+
+} // namespace coffee
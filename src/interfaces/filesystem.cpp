@@ -7,9 +7,7 @@
 
 #include <fstream>
 
-// This one must be defined here because ZSTD uses it internally
-#include <xxh3/xxhash.h>
-#include <zstd/zstddeclib.c>
+#include <zstd/zstd.h>
 
 namespace coffee {
 
@@ -59,6 +57,35 @@ namespace coffee {
             }
         }
 
+        AssetError errorCodeToAssetError(const std::error_code& ec) noexcept
+        {
+            if (ec == std::errc::no_such_file_or_directory) {
+                return AssetError::FileNotFound;
+            }
+
+            if (ec == std::errc::is_a_directory) {
+                return AssetError::InvalidFileType;
+            }
+
+            return AssetError::ImplementationFailure;
+        }
+
+        [[noreturn]] void throwFilesystemError(AssetError error, const AssetId& id)
+        {
+            switch (error) {
+                case AssetError::FileNotFound:
+                    throw FilesystemException { FilesystemException::Type::FileNotFound, fmt::format("File '{}' doesn't exist!", id.path()) };
+                case AssetError::InvalidFileType:
+                    throw FilesystemException { FilesystemException::Type::InvalidFileType, fmt::format("Path '{}' isn't a regular file!", id.path()) };
+                case AssetError::DecompressionFailure:
+                    throw FilesystemException { FilesystemException::Type::DecompressionFailure,
+                                                fmt::format("Failed to decompress file '{}'!", id.path()) };
+                default:
+                    throw FilesystemException { FilesystemException::Type::ImplementationFailure,
+                                                fmt::format("Implementation failed to read file '{}'!", id.path()) };
+            }
+        }
+
     } // namespace detail
 
     Filesystem::Filesystem(const std::string& path) : basePath { path } {};
@@ -92,28 +119,49 @@ namespace coffee {
         }
     }
 
+    Filesystem::Entry Filesystem::getMetadata(const AssetId& id) const
+    {
+        Expected<Filesystem::Entry> result = tryGetMetadata(id);
+
+        if (!result) {
+            detail::throwFilesystemError(result.error(), id);
+        }
+
+        return std::move(result).value();
+    }
+
+    std::vector<uint8_t> Filesystem::getContent(const AssetId& id) const
+    {
+        Expected<std::vector<uint8_t>> result = tryGetContent(id);
+
+        if (!result) {
+            detail::throwFilesystemError(result.error(), id);
+        }
+
+        return std::move(result).value();
+    }
+
+    ByteBufferPtr Filesystem::getBuffer(const AssetId& id) const { return std::make_shared<ByteBuffer>(getContent(id)); }
+
     NativeFilesystem::NativeFilesystem(const std::string& path) : Filesystem { path } {}
 
-    bool NativeFilesystem::contains(const std::string& path) const noexcept
+    bool NativeFilesystem::contains(const AssetId& id) const noexcept
     {
         std::error_code ec {};
-        auto status = std::filesystem::status(path, ec);
+        auto status = std::filesystem::status(std::filesystem::path(basePath) / id.path(), ec);
 
         return !ec && status.type() == std::filesystem::file_type::regular;
     }
 
-    Filesystem::Entry NativeFilesystem::getMetadata(const std::string& path) const
+    Expected<Filesystem::Entry> NativeFilesystem::tryGetMetadata(const AssetId& id) const
     {
-        std::filesystem::path fullPath = std::filesystem::path(basePath) / path;
+        std::filesystem::path fullPath = std::filesystem::path(basePath) / id.path();
 
         std::error_code ec {};
         uintmax_t fileSize = std::filesystem::file_size(fullPath, ec);
 
         if (ec) {
-            throw FilesystemException {
-                FilesystemException::Type::ImplementationFailure,
-                fmt::format("Implementation failed to get file size of file '{}' with following message: {}!", path, ec.message())
-            };
+            return detail::errorCodeToAssetError(ec);
         }
 
         Filesystem::Entry result {};
@@ -126,16 +174,33 @@ namespace coffee {
         return result;
     }
 
-    std::vector<uint8_t> NativeFilesystem::getContent(const std::string& path) const
+    Expected<std::vector<uint8_t>> NativeFilesystem::tryGetContent(const AssetId& id) const
     {
-        std::filesystem::path fullPath = std::filesystem::path(basePath) / path;
+        std::filesystem::path fullPath = std::filesystem::path(basePath) / id.path();
 
-        return utils::readFile(fullPath.string());
+        std::error_code ec {};
+        uintmax_t fileSize = std::filesystem::file_size(fullPath, ec);
+
+        if (ec) {
+            return detail::errorCodeToAssetError(ec);
+        }
+
+        std::ifstream file { fullPath, std::ios::in | std::ios::binary };
+
+        if (!file.is_open()) {
+            return AssetError::ImplementationFailure;
+        }
+
+        std::vector<uint8_t> buffer {};
+        buffer.resize(fileSize);
+        file.read(reinterpret_cast<char*>(buffer.data()), fileSize);
+
+        return buffer;
     }
 
-    utils::ReaderStream NativeFilesystem::getStream(const std::string& path) const
+    utils::ReaderStream NativeFilesystem::getStream(const AssetId& id) const
     {
-        std::filesystem::path fullPath = std::filesystem::path(basePath) / path;
+        std::filesystem::path fullPath = std::filesystem::path(basePath) / id.path();
         uint8_t* pointer = nullptr;
         size_t size = utils::readFile(fullPath.string(), pointer);
 
@@ -197,17 +262,17 @@ namespace coffee {
         }
     }
 
-    bool VirtualFilesystem::contains(const std::string& path) const noexcept
+    bool VirtualFilesystem::contains(const AssetId& id) const noexcept
     {
-        return entries_.find(XXH3_64bits(path.data(), path.size())) != entries_.end();
+        return entries_.find(id.hash()) != entries_.end();
     }
 
-    Filesystem::Entry VirtualFilesystem::getMetadata(const std::string& path) const
+    Expected<Filesystem::Entry> VirtualFilesystem::tryGetMetadata(const AssetId& id) const
     {
-        auto it = entries_.find(XXH3_64bits(path.data(), path.size()));
+        auto it = entries_.find(id.hash());
 
         if (it == entries_.end()) {
-            throw FilesystemException { FilesystemException::Type::FileNotFound, fmt::format("File '{}' doesn't exist!", path) };
+            return AssetError::FileNotFound;
         }
 
         Entry result {};
@@ -222,12 +287,12 @@ namespace coffee {
         return result;
     }
 
-    std::vector<uint8_t> VirtualFilesystem::getContent(const std::string& path) const
+    Expected<std::vector<uint8_t>> VirtualFilesystem::tryGetContent(const AssetId& id) const
     {
-        auto it = entries_.find(XXH3_64bits(path.data(), path.size()));
+        auto it = entries_.find(id.hash());
 
         if (it == entries_.end()) {
-            throw FilesystemException { FilesystemException::Type::FileNotFound, fmt::format("File '{}' doesn't exist!", path) };
+            return AssetError::FileNotFound;
         }
 
         auto& entry = it->second;
@@ -254,20 +319,19 @@ namespace coffee {
         if (ZSTD_isError(errorCode)) {
             const char* description = ZSTD_getErrorName(errorCode);
             COFFEE_ERROR("ZSTD frame header returned error: {}!", description);
-
-            throw FilesystemException { FilesystemException::Type::DecompressionFailure,
-                                        fmt::format("ZSTD frame header returned error: {}!", description) };
+            return AssetError::DecompressionFailure;
         }
 
         size_t decompressedSize = frameHeader.frameContentSize;
 
         // Empty files allowed too, but not very useful
         if (decompressedSize == 0) {
-            return {};
+            return std::vector<uint8_t> {};
         }
 
         if (decompressedSize == ZSTD_CONTENTSIZE_UNKNOWN) {
-            throw FilesystemException { FilesystemException::Type::DecompressionFailure, "Failed to gather compressed size of frame!" };
+            COFFEE_ERROR("Failed to gather compressed size of frame!");
+            return AssetError::DecompressionFailure;
         }
 
         std::vector<uint8_t> decompressedBytes {};
@@ -278,20 +342,36 @@ namespace coffee {
         if (ZSTD_isError(errorCode)) {
             const char* description = ZSTD_getErrorName(errorCode);
             COFFEE_ERROR("ZSTD decompression returned error: {}!", description);
-
-            throw FilesystemException { FilesystemException::Type::DecompressionFailure,
-                                        fmt::format("ZSTD decompression returned error: {}!", description) };
+            return AssetError::DecompressionFailure;
         }
 
         return decompressedBytes;
     }
 
-    utils::ReaderStream VirtualFilesystem::getStream(const std::string& path) const
+    ByteBufferPtr VirtualFilesystem::getBuffer(const AssetId& id) const
+    {
+        auto it = entries_.find(id.hash());
+
+        if (it == entries_.end()) {
+            throw FilesystemException { FilesystemException::Type::FileNotFound, fmt::format("File '{}' doesn't exist!", id.path()) };
+        }
+
+        auto& entry = it->second;
+
+        // Uncompressed files can be given directly from mapped archive, buffer will keep whole filesystem alive instead
+        if (entry.compressedSize == 0) {
+            return std::make_shared<ByteBuffer>(archiveFile_.data() + entry.position, entry.uncompressedSize, shared_from_this());
+        }
+
+        return std::make_shared<ByteBuffer>(getContent(id));
+    }
+
+    utils::ReaderStream VirtualFilesystem::getStream(const AssetId& id) const
     {
-        auto it = entries_.find(XXH3_64bits(path.data(), path.size()));
+        auto it = entries_.find(id.hash());
 
         if (it == entries_.end()) {
-            throw FilesystemException { FilesystemException::Type::FileNotFound, fmt::format("File '{}' doesn't exist!", path) };
+            throw FilesystemException { FilesystemException::Type::FileNotFound, fmt::format("File '{}' doesn't exist!", id.path()) };
         }
 
         auto& entry = it->second;
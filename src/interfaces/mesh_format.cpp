@@ -0,0 +1,554 @@
+#include <coffee/interfaces/mesh_format.hpp>
+
+#include <coffee/interfaces/exceptions.hpp>
+#include <coffee/utils/utils.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+namespace coffee {
+
+    namespace detail {
+
+        constexpr uint8_t kLegacyHeaderMagic[4] = { 0xF0, 0x7B, 0xAE, 0x31 };
+        constexpr uint8_t kLegacyMeshMagic[4] = { 0x13, 0xEA, 0xB7, 0xF0 };
+        constexpr uint8_t kHeaderMagic[4] = { 0xF0, 0x7B, 0xAE, 0x32 };
+
+        enum class MeshSection : uint32_t {
+            SubMeshes = 0,
+            Strings = 1,
+            Vertices = 2,
+            Indices = 3,
+            Meshlets = 4,
+            MeshletRanges = 5,
+            Lods = 6,
+        };
+
+        constexpr size_t kAmountOfKnownSections = 7ULL;
+        constexpr uint32_t kMaxShortIndexVertices = 0xFFFFU;
+
+        // Vertices are encoded per submesh, because compact formats are relative to AABB of their submesh
+        template <typename T>
+        void encodeVertices(const MeshView& mesh, uint8_t* destination) noexcept
+        {
+            T* output = reinterpret_cast<T*>(destination);
+
+            for (const MeshData::SubMesh& subMesh : mesh.subMeshes) {
+                for (uint32_t index = subMesh.verticesOffset; index < subMesh.verticesOffset + subMesh.verticesCount; index++) {
+                    // Source might be unaligned when it's viewed directly from archive
+                    graphics::Vertex vertex {};
+                    std::memcpy(&vertex, mesh.vertices + static_cast<size_t>(index) * sizeof(graphics::Vertex), sizeof(graphics::Vertex));
+                    output[index] = T::encode(vertex, subMesh.aabbMin, subMesh.aabbMax);
+                }
+            }
+        }
+
+        // Every structure below consists only of 4-byte fields, so there's no padding between them
+        struct MeshFileHeader {
+            uint8_t magic[4] {};
+            uint32_t version = 0;
+            uint32_t amountOfSubMeshes = 0;
+            uint32_t amountOfSections = 0;
+            // Stored explicitly, so files with different vertex layout are rejected instead of being silently misread
+            uint32_t vertexStride = 0;
+            uint32_t indexSize = 0;
+            uint32_t reserved[2] {};
+        };
+
+        struct MeshFileSection {
+            uint32_t type = 0;
+            uint32_t reserved = 0;
+            uint64_t offset = 0;
+            uint64_t size = 0;
+        };
+
+        struct MeshFileSubMesh {
+            float aabbMin[3] {};
+            float aabbMax[3] {};
+            float diffuseColor[3] {};
+            float specularColor[3] {};
+            float metallicFactor = 0.0f;
+            float roughnessFactor = 0.0f;
+            uint32_t verticesOffset = 0;
+            uint32_t verticesCount = 0;
+            uint32_t indicesOffset = 0;
+            uint32_t indicesCount = 0;
+            // Offsets are relative to beginning of string section
+            uint32_t textureOffsets[MeshData::kAmountOfTextures] {};
+            uint32_t textureSizes[MeshData::kAmountOfTextures] {};
+        };
+
+        // One per submesh, stored separately from submesh table so files without meshlets keep same layout
+        struct MeshFileMeshletRange {
+            uint32_t offset = 0;
+            uint32_t count = 0;
+        };
+
+        // Sorted by submesh and then by level, so LODs are read back in same order
+        struct MeshFileLod {
+            uint32_t subMesh = 0;
+            uint32_t indicesOffset = 0;
+            uint32_t indicesCount = 0;
+            float error = 0.0f;
+        };
+
+        static_assert(sizeof(MeshFileHeader) == 32, "Mesh file header must not contain padding.");
+        static_assert(sizeof(MeshFileSection) == 24, "Mesh file section must not contain padding.");
+        static_assert(sizeof(MeshFileSubMesh) == 128, "Mesh file submesh must not contain padding.");
+        static_assert(sizeof(MeshFileMeshletRange) == 8, "Mesh file meshlet range must not contain padding.");
+        static_assert(sizeof(MeshFileLod) == 16, "Mesh file LOD must not contain padding.");
+
+        constexpr size_t alignRegion(size_t offset) noexcept
+        {
+            return (offset + MeshFormat::kRegionAlignment - 1) & ~(MeshFormat::kRegionAlignment - 1);
+        }
+
+        [[noreturn]] void throwInvalidMesh(const char* reason)
+        {
+            throw FilesystemException { FilesystemException::Type::InvalidFileType, fmt::format("Invalid mesh file: {}!", reason) };
+        }
+
+        std::string readLegacyName(utils::ReaderStream& stream)
+        {
+            uint8_t size = stream.read<uint8_t>();
+            std::string result {};
+
+            if (size != 0) {
+                result.resize(size);
+                stream.readDirectly(result.data(), size);
+            }
+
+            return result;
+        }
+
+        MeshData readLegacyMesh(const uint8_t* data, size_t size)
+        {
+            utils::ReaderStream stream { data, size };
+            stream.readBuffer<uint8_t, 4>();
+
+            uint32_t amountOfSubMeshes = stream.read<uint32_t>();
+
+            MeshData result {};
+            result.subMeshes.resize(amountOfSubMeshes);
+
+            for (auto& subMesh : result.subMeshes) {
+                if (stream.size() - stream.offset() < sizeof(kLegacyMeshMagic) + 2 * sizeof(uint32_t) ||
+                    std::memcmp(stream.readBuffer<uint8_t, 4>(), kLegacyMeshMagic, sizeof(kLegacyMeshMagic)) != 0) {
+                    throwInvalidMesh("invalid submesh magic");
+                }
+
+                subMesh.verticesCount = stream.read<uint32_t>();
+                subMesh.indicesCount = stream.read<uint32_t>();
+
+                stream.readDirectly(&subMesh.aabbMin);
+                stream.readDirectly(&subMesh.aabbMax);
+                stream.readDirectly(&subMesh.modifiers.diffuseColor);
+                stream.readDirectly(&subMesh.modifiers.specularColor);
+                stream.readDirectly(&subMesh.modifiers.metallicFactor);
+                stream.readDirectly(&subMesh.modifiers.roughnessFactor);
+
+                for (auto& texture : subMesh.textures) {
+                    texture = readLegacyName(stream);
+                }
+
+                size_t remainingBytes = stream.size() - stream.offset();
+                size_t geometryBytes = static_cast<size_t>(subMesh.verticesCount) * sizeof(graphics::Vertex) +
+                                       static_cast<size_t>(subMesh.indicesCount) * sizeof(uint32_t);
+
+                if (geometryBytes > remainingBytes) {
+                    throwInvalidMesh("submesh geometry is out of bounds");
+                }
+
+                subMesh.verticesOffset = static_cast<uint32_t>(result.vertices.size());
+                subMesh.indicesOffset = static_cast<uint32_t>(result.indices.size());
+
+                result.vertices.resize(result.vertices.size() + subMesh.verticesCount);
+                result.indices.resize(result.indices.size() + subMesh.indicesCount);
+                stream.readDirectly(result.vertices.data() + subMesh.verticesOffset, subMesh.verticesCount);
+                stream.readDirectly(result.indices.data() + subMesh.indicesOffset, subMesh.indicesCount);
+            }
+
+            return result;
+        }
+
+    } // namespace detail
+
+    uint32_t MeshFormat::version(const uint8_t* data, size_t size) noexcept
+    {
+        if (data == nullptr || size < 8) {
+            return 0U;
+        }
+
+        if (std::memcmp(data, detail::kLegacyHeaderMagic, sizeof(detail::kLegacyHeaderMagic)) == 0) {
+            return 1U;
+        }
+
+        if (size < sizeof(detail::MeshFileHeader) || std::memcmp(data, detail::kHeaderMagic, sizeof(detail::kHeaderMagic)) != 0) {
+            return 0U;
+        }
+
+        uint32_t version = 0U;
+        std::memcpy(&version, data + offsetof(detail::MeshFileHeader, version), sizeof(version));
+
+        return version;
+    }
+
+    MeshData MeshFormat::read(const uint8_t* data, size_t size)
+    {
+        switch (version(data, size)) {
+            case 1U:
+                return detail::readLegacyMesh(data, size);
+            case kLatestVersion: {
+                MeshView meshView = view(data, size);
+
+                MeshData result {};
+                result.subMeshes = std::move(meshView.subMeshes);
+                result.meshlets = std::move(meshView.meshlets);
+                result.vertices.resize(meshView.verticesSize / sizeof(graphics::Vertex));
+                result.indices.resize(meshView.indicesSize / meshView.indexSize);
+                std::memcpy(result.vertices.data(), meshView.vertices, meshView.verticesSize);
+                copyIndices(meshView, reinterpret_cast<uint8_t*>(result.indices.data()), sizeof(uint32_t));
+
+                return result;
+            }
+            default:
+                detail::throwInvalidMesh("unknown header or version");
+        }
+    }
+
+    MeshView MeshFormat::view(const uint8_t* data, size_t size)
+    {
+        using namespace detail;
+
+        if (version(data, size) != kLatestVersion) {
+            throwInvalidMesh("only latest version can be viewed");
+        }
+
+        MeshFileHeader header {};
+        std::memcpy(&header, data, sizeof(header));
+
+        if (header.vertexStride != sizeof(graphics::Vertex) || (header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(uint32_t))) {
+            throwInvalidMesh("unsupported vertex or index layout");
+        }
+
+        size_t sectionsSize = static_cast<size_t>(header.amountOfSections) * sizeof(MeshFileSection);
+
+        if (sectionsSize > size - sizeof(header)) {
+            throwInvalidMesh("section table is out of bounds");
+        }
+
+        const uint8_t* sections[kAmountOfKnownSections] {};
+        size_t sectionSizes[kAmountOfKnownSections] {};
+
+        for (uint32_t index = 0; index < header.amountOfSections; index++) {
+            MeshFileSection section {};
+            std::memcpy(&section, data + sizeof(header) + index * sizeof(MeshFileSection), sizeof(section));
+
+            if (section.offset > size || section.size > size - section.offset) {
+                throwInvalidMesh("section is out of bounds");
+            }
+
+            // Unknown sections are skipped, so files written by newer packers can be read as long as layout matches
+            if (section.type < kAmountOfKnownSections) {
+                sections[section.type] = data + section.offset;
+                sectionSizes[section.type] = section.size;
+            }
+        }
+
+        const size_t subMeshesIndex = static_cast<size_t>(MeshSection::SubMeshes);
+        const size_t stringsIndex = static_cast<size_t>(MeshSection::Strings);
+        const size_t verticesIndex = static_cast<size_t>(MeshSection::Vertices);
+        const size_t indicesIndex = static_cast<size_t>(MeshSection::Indices);
+        const size_t meshletsIndex = static_cast<size_t>(MeshSection::Meshlets);
+        const size_t meshletRangesIndex = static_cast<size_t>(MeshSection::MeshletRanges);
+        const size_t lodsIndex = static_cast<size_t>(MeshSection::Lods);
+
+        if (sectionSizes[subMeshesIndex] != static_cast<size_t>(header.amountOfSubMeshes) * sizeof(MeshFileSubMesh)) {
+            throwInvalidMesh("submesh table doesn't match header");
+        }
+
+        // Files written before meshlets were introduced don't have either section
+        if (sectionSizes[meshletRangesIndex] != 0 &&
+            sectionSizes[meshletRangesIndex] != static_cast<size_t>(header.amountOfSubMeshes) * sizeof(MeshFileMeshletRange)) {
+            throwInvalidMesh("meshlet ranges don't match header");
+        }
+
+        MeshView result {};
+        result.vertices = sections[verticesIndex];
+        result.verticesSize = sectionSizes[verticesIndex] - sectionSizes[verticesIndex] % sizeof(graphics::Vertex);
+        result.indices = sections[indicesIndex];
+        result.indicesSize = sectionSizes[indicesIndex] - sectionSizes[indicesIndex] % header.indexSize;
+        result.indexSize = header.indexSize;
+        result.subMeshes.resize(header.amountOfSubMeshes);
+
+        if (sectionSizes[meshletRangesIndex] != 0) {
+            result.meshlets.resize(sectionSizes[meshletsIndex] / sizeof(graphics::Meshlet));
+            std::memcpy(result.meshlets.data(), sections[meshletsIndex], result.meshlets.size() * sizeof(graphics::Meshlet));
+        }
+
+        const size_t amountOfVertices = result.verticesSize / sizeof(graphics::Vertex);
+        const size_t amountOfIndices = result.indicesSize / result.indexSize;
+        const char* strings = reinterpret_cast<const char*>(sections[stringsIndex]);
+        const size_t stringsSize = sectionSizes[stringsIndex];
+
+        for (uint32_t index = 0; index < header.amountOfSubMeshes; index++) {
+            MeshFileSubMesh record {};
+            std::memcpy(&record, sections[subMeshesIndex] + index * sizeof(MeshFileSubMesh), sizeof(record));
+
+            if (static_cast<size_t>(record.verticesOffset) + record.verticesCount > amountOfVertices ||
+                static_cast<size_t>(record.indicesOffset) + record.indicesCount > amountOfIndices) {
+                throwInvalidMesh("submesh geometry is out of bounds");
+            }
+
+            MeshData::SubMesh& subMesh = result.subMeshes[index];
+            subMesh.aabbMin = { record.aabbMin[0], record.aabbMin[1], record.aabbMin[2] };
+            subMesh.aabbMax = { record.aabbMax[0], record.aabbMax[1], record.aabbMax[2] };
+            subMesh.modifiers.diffuseColor = { record.diffuseColor[0], record.diffuseColor[1], record.diffuseColor[2] };
+            subMesh.modifiers.specularColor = { record.specularColor[0], record.specularColor[1], record.specularColor[2] };
+            subMesh.modifiers.metallicFactor = record.metallicFactor;
+            subMesh.modifiers.roughnessFactor = record.roughnessFactor;
+            subMesh.verticesOffset = record.verticesOffset;
+            subMesh.verticesCount = record.verticesCount;
+            subMesh.indicesOffset = record.indicesOffset;
+            subMesh.indicesCount = record.indicesCount;
+
+            // Packer never produces such files, but they would be silently misread by every draw of this submesh
+            if (result.indexSize == sizeof(uint16_t) && record.verticesCount > kMaxShortIndexVertices) {
+                throwInvalidMesh("submesh has too many vertices for 16-bit indices");
+            }
+
+            for (size_t texture = 0; texture < MeshData::kAmountOfTextures; texture++) {
+                if (record.textureSizes[texture] == 0) {
+                    continue;
+                }
+
+                if (static_cast<size_t>(record.textureOffsets[texture]) + record.textureSizes[texture] > stringsSize) {
+                    throwInvalidMesh("texture name is out of bounds");
+                }
+
+                subMesh.textures[texture].assign(strings + record.textureOffsets[texture], record.textureSizes[texture]);
+            }
+
+            if (sectionSizes[meshletRangesIndex] == 0) {
+                continue;
+            }
+
+            MeshFileMeshletRange range {};
+            std::memcpy(&range, sections[meshletRangesIndex] + index * sizeof(MeshFileMeshletRange), sizeof(range));
+
+            if (static_cast<size_t>(range.offset) + range.count > result.meshlets.size()) {
+                throwInvalidMesh("meshlet range is out of bounds");
+            }
+
+            // Meshlets are drawn directly, so each one must stay inside indices of it's submesh
+            for (uint32_t meshlet = range.offset; meshlet < range.offset + range.count; meshlet++) {
+                const graphics::Meshlet& data = result.meshlets[meshlet];
+
+                if (data.indicesOffset < record.indicesOffset ||
+                    static_cast<size_t>(data.indicesOffset) + data.indicesCount > static_cast<size_t>(record.indicesOffset) + record.indicesCount) {
+                    throwInvalidMesh("meshlet indices are out of submesh bounds");
+                }
+            }
+
+            subMesh.meshletsOffset = range.offset;
+            subMesh.meshletsCount = range.count;
+        }
+
+        for (size_t offset = 0; offset + sizeof(MeshFileLod) <= sectionSizes[lodsIndex]; offset += sizeof(MeshFileLod)) {
+            MeshFileLod record {};
+            std::memcpy(&record, sections[lodsIndex] + offset, sizeof(record));
+
+            if (record.subMesh >= header.amountOfSubMeshes ||
+                static_cast<size_t>(record.indicesOffset) + record.indicesCount > amountOfIndices) {
+                throwInvalidMesh("LOD is out of bounds");
+            }
+
+            graphics::SubMeshLod lod {};
+            lod.indicesOffset = record.indicesOffset;
+            lod.indicesCount = record.indicesCount;
+            lod.error = record.error;
+            result.subMeshes[record.subMesh].lods.push_back(lod);
+        }
+
+        return result;
+    }
+
+    MeshView MeshFormat::view(const MeshData& mesh)
+    {
+        MeshView result {};
+        result.subMeshes = mesh.subMeshes;
+        result.meshlets = mesh.meshlets;
+        result.vertices = reinterpret_cast<const uint8_t*>(mesh.vertices.data());
+        result.verticesSize = mesh.vertices.size() * sizeof(graphics::Vertex);
+        result.indices = reinterpret_cast<const uint8_t*>(mesh.indices.data());
+        result.indicesSize = mesh.indices.size() * sizeof(uint32_t);
+
+        return result;
+    }
+
+    bool MeshFormat::fitsShortIndices(const std::vector<MeshData::SubMesh>& subMeshes) noexcept
+    {
+        return std::all_of(subMeshes.begin(), subMeshes.end(), [](const MeshData::SubMesh& subMesh) {
+            return subMesh.verticesCount <= detail::kMaxShortIndexVertices;
+        });
+    }
+
+    void MeshFormat::copyIndices(const MeshView& mesh, uint8_t* destination, uint32_t indexSize) noexcept
+    {
+        if (mesh.indexSize == indexSize) {
+            std::memcpy(destination, mesh.indices, mesh.indicesSize);
+            return;
+        }
+
+        const size_t amountOfIndices = mesh.indicesSize / mesh.indexSize;
+
+        // Source might be unaligned when it's viewed directly from archive, so every index is copied through memcpy
+        for (size_t index = 0; index < amountOfIndices; index++) {
+            if (indexSize == sizeof(uint16_t)) {
+                uint32_t value = 0U;
+                std::memcpy(&value, mesh.indices + index * sizeof(uint32_t), sizeof(uint32_t));
+                reinterpret_cast<uint16_t*>(destination)[index] = static_cast<uint16_t>(value);
+            }
+            else {
+                uint16_t value = 0U;
+                std::memcpy(&value, mesh.indices + index * sizeof(uint16_t), sizeof(uint16_t));
+                reinterpret_cast<uint32_t*>(destination)[index] = value;
+            }
+        }
+    }
+
+    void MeshFormat::copyVertices(const MeshView& mesh, uint8_t* destination, graphics::VertexFormat format) noexcept
+    {
+        switch (format) {
+            case graphics::VertexFormat::Full:
+                std::memcpy(destination, mesh.vertices, mesh.verticesSize);
+                break;
+            case graphics::VertexFormat::Compact:
+                detail::encodeVertices<graphics::CompactVertex>(mesh, destination);
+                break;
+        }
+    }
+
+    void MeshFormat::copyPositions(const MeshView& mesh, uint8_t* destination, graphics::VertexFormat format) noexcept
+    {
+        switch (format) {
+            case graphics::VertexFormat::Full:
+                detail::encodeVertices<graphics::PositionVertex>(mesh, destination);
+                break;
+            case graphics::VertexFormat::Compact:
+                detail::encodeVertices<graphics::CompactPositionVertex>(mesh, destination);
+                break;
+        }
+    }
+
+    std::vector<uint8_t> MeshFormat::write(const MeshData& mesh)
+    {
+        using namespace detail;
+
+        const uint32_t indexSize = fitsShortIndices(mesh.subMeshes) ? sizeof(uint16_t) : sizeof(uint32_t);
+
+        std::vector<MeshFileSubMesh> records {};
+        std::vector<MeshFileMeshletRange> meshletRanges {};
+        std::vector<MeshFileLod> lods {};
+        std::string strings {};
+        records.resize(mesh.subMeshes.size());
+
+        for (size_t index = 0; index < mesh.subMeshes.size(); index++) {
+            const MeshData::SubMesh& subMesh = mesh.subMeshes[index];
+            MeshFileSubMesh& record = records[index];
+
+            std::memcpy(record.aabbMin, &subMesh.aabbMin, sizeof(record.aabbMin));
+            std::memcpy(record.aabbMax, &subMesh.aabbMax, sizeof(record.aabbMax));
+            std::memcpy(record.diffuseColor, &subMesh.modifiers.diffuseColor, sizeof(record.diffuseColor));
+            std::memcpy(record.specularColor, &subMesh.modifiers.specularColor, sizeof(record.specularColor));
+            record.metallicFactor = subMesh.modifiers.metallicFactor;
+            record.roughnessFactor = subMesh.modifiers.roughnessFactor;
+            record.verticesOffset = subMesh.verticesOffset;
+            record.verticesCount = subMesh.verticesCount;
+            record.indicesOffset = subMesh.indicesOffset;
+            record.indicesCount = subMesh.indicesCount;
+
+            if (!mesh.meshlets.empty()) {
+                meshletRanges.push_back({ subMesh.meshletsOffset, subMesh.meshletsCount });
+            }
+
+            for (const auto& lod : subMesh.lods) {
+                lods.push_back({ static_cast<uint32_t>(index), lod.indicesOffset, lod.indicesCount, lod.error });
+            }
+
+            for (size_t texture = 0; texture < MeshData::kAmountOfTextures; texture++) {
+                const std::string& name = subMesh.textures[texture];
+
+                if (name.empty()) {
+                    continue;
+                }
+
+                // Most submeshes are sharing textures, so names are deduplicated
+                size_t position = strings.find(name);
+
+                if (position == std::string::npos) {
+                    position = strings.size();
+                    strings += name;
+                }
+
+                record.textureOffsets[texture] = static_cast<uint32_t>(position);
+                record.textureSizes[texture] = static_cast<uint32_t>(name.size());
+            }
+        }
+
+        MeshFileSection sections[kAmountOfKnownSections] {};
+        sections[0].type = static_cast<uint32_t>(MeshSection::SubMeshes);
+        sections[0].offset = sizeof(MeshFileHeader) + sizeof(sections);
+        sections[0].size = records.size() * sizeof(MeshFileSubMesh);
+        sections[1].type = static_cast<uint32_t>(MeshSection::Strings);
+        sections[1].offset = sections[0].offset + sections[0].size;
+        sections[1].size = strings.size();
+        sections[2].type = static_cast<uint32_t>(MeshSection::MeshletRanges);
+        sections[2].offset = sections[1].offset + sections[1].size;
+        sections[2].size = meshletRanges.size() * sizeof(MeshFileMeshletRange);
+        sections[3].type = static_cast<uint32_t>(MeshSection::Lods);
+        sections[3].offset = sections[2].offset + sections[2].size;
+        sections[3].size = lods.size() * sizeof(MeshFileLod);
+        sections[4].type = static_cast<uint32_t>(MeshSection::Vertices);
+        sections[4].offset = alignRegion(sections[3].offset + sections[3].size);
+        sections[4].size = mesh.vertices.size() * sizeof(graphics::Vertex);
+        sections[5].type = static_cast<uint32_t>(MeshSection::Indices);
+        sections[5].offset = alignRegion(sections[4].offset + sections[4].size);
+        sections[5].size = mesh.indices.size() * indexSize;
+        // Meshlets are region as well, so they can be uploaded for compute culling without any conversion
+        sections[6].type = static_cast<uint32_t>(MeshSection::Meshlets);
+        sections[6].offset = alignRegion(sections[5].offset + sections[5].size);
+        sections[6].size = mesh.meshlets.size() * sizeof(graphics::Meshlet);
+
+        MeshFileHeader header {};
+        std::memcpy(header.magic, kHeaderMagic, sizeof(kHeaderMagic));
+        header.version = kLatestVersion;
+        header.amountOfSubMeshes = static_cast<uint32_t>(records.size());
+        header.amountOfSections = static_cast<uint32_t>(kAmountOfKnownSections);
+        header.vertexStride = sizeof(graphics::Vertex);
+        header.indexSize = indexSize;
+
+        // Padding between regions is zeroed by resize
+        std::vector<uint8_t> result {};
+        result.resize(sections[6].offset + sections[6].size);
+
+        std::memcpy(result.data(), &header, sizeof(header));
+        std::memcpy(result.data() + sizeof(header), sections, sizeof(sections));
+        std::memcpy(result.data() + sections[0].offset, records.data(), sections[0].size);
+        std::memcpy(result.data() + sections[1].offset, strings.data(), sections[1].size);
+        std::memcpy(result.data() + sections[2].offset, meshletRanges.data(), sections[2].size);
+        std::memcpy(result.data() + sections[3].offset, lods.data(), sections[3].size);
+        std::memcpy(result.data() + sections[4].offset, mesh.vertices.data(), sections[4].size);
+        std::memcpy(result.data() + sections[6].offset, mesh.meshlets.data(), sections[6].size);
+
+        // Indices might be narrowed, so they're written through same path as at load time
+        MeshView indicesView {};
+        indicesView.indices = reinterpret_cast<const uint8_t*>(mesh.indices.data());
+        indicesView.indicesSize = mesh.indices.size() * sizeof(uint32_t);
+        copyIndices(indicesView, result.data() + sections[5].offset, indexSize);
+
+        return result;
+    }
+
+} // namespace coffee
@@ -0,0 +1,1205 @@
+#include <coffee/interfaces/mesh_optimizer.hpp>
+
+#include <coffee/interfaces/exceptions.hpp>
+
+#include <oneapi/tbb/parallel_for.h>
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace coffee {
+
+    namespace detail {
+
+        constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        // Adjacency in compressed form, triangles of vertex are stored in range [offsets[vertex], offsets[vertex + 1])
+        struct VertexTriangles {
+            std::vector<uint32_t> offsets {};
+            std::vector<uint32_t> triangles {};
+        };
+
+        void validateIndices(const MeshData& mesh, uint32_t indicesOffset, uint32_t indicesCount, uint32_t amountOfVertices)
+        {
+            if (static_cast<size_t>(indicesOffset) + indicesCount > mesh.indices.size()) {
+                throw FilesystemException { FilesystemException::Type::InvalidFileType, "Invalid mesh file: indices are out of bounds!" };
+            }
+
+            const uint32_t* indices = mesh.indices.data() + indicesOffset;
+
+            for (size_t index = 0; index < indicesCount; index++) {
+                if (indices[index] >= amountOfVertices) {
+                    throw FilesystemException { FilesystemException::Type::InvalidFileType, "Invalid mesh file: index is out of submesh bounds!" };
+                }
+            }
+        }
+
+        struct SubMeshRange {
+            uint32_t begin = 0U;
+            uint32_t end = 0U;
+            size_t subMesh = 0ULL;
+        };
+
+        void appendRange(std::vector<SubMeshRange>& ranges, uint32_t offset, uint32_t count, size_t subMesh)
+        {
+            if (count > 0) {
+                ranges.push_back({ offset, offset + count, subMesh });
+            }
+        }
+
+        // Ranges are sorted by beginning, so range overlaps range of other submesh only if it begins before furthest end seen so far
+        // Ranges of same submesh (base indices and LODs) are allowed to overlap, because they're processed by single task
+        bool hasSharedRanges(std::vector<SubMeshRange>& ranges)
+        {
+            std::sort(ranges.begin(), ranges.end(), [](const SubMeshRange& lhs, const SubMeshRange& rhs) { return lhs.begin < rhs.begin; });
+
+            uint32_t furthestEnd = 0U;
+            size_t furthestSubMesh = 0ULL;
+
+            for (const SubMeshRange& range : ranges) {
+                if (range.begin < furthestEnd && range.subMesh != furthestSubMesh) {
+                    return true;
+                }
+
+                if (range.end > furthestEnd) {
+                    furthestEnd = range.end;
+                    furthestSubMesh = range.subMesh;
+                }
+            }
+
+            return false;
+        }
+
+        // Every optimization indexes per-vertex arrays directly, so malformed geometry must be rejected before any of them
+        // Submeshes are also processed in parallel and in place, so they must never share vertices or indices
+        void validateSubMeshes(const MeshData& mesh)
+        {
+            std::vector<SubMeshRange> vertexRanges {};
+            std::vector<SubMeshRange> indexRanges {};
+
+            for (size_t index = 0; index < mesh.subMeshes.size(); index++) {
+                const MeshData::SubMesh& subMesh = mesh.subMeshes[index];
+
+                if (static_cast<size_t>(subMesh.verticesOffset) + subMesh.verticesCount > mesh.vertices.size()) {
+                    throw FilesystemException { FilesystemException::Type::InvalidFileType, "Invalid mesh file: vertices are out of bounds!" };
+                }
+
+                if (static_cast<size_t>(subMesh.meshletsOffset) + subMesh.meshletsCount > mesh.meshlets.size()) {
+                    throw FilesystemException { FilesystemException::Type::InvalidFileType, "Invalid mesh file: meshlets are out of bounds!" };
+                }
+
+                validateIndices(mesh, subMesh.indicesOffset, subMesh.indicesCount, subMesh.verticesCount);
+                appendRange(vertexRanges, subMesh.verticesOffset, subMesh.verticesCount, index);
+                appendRange(indexRanges, subMesh.indicesOffset, subMesh.indicesCount, index);
+
+                for (const auto& lod : subMesh.lods) {
+                    validateIndices(mesh, lod.indicesOffset, lod.indicesCount, subMesh.verticesCount);
+                    appendRange(indexRanges, lod.indicesOffset, lod.indicesCount, index);
+                }
+
+                // Meshlets are used as clusters of submesh triangles, so they must stay inside of it's indices
+                const size_t indicesEnd = static_cast<size_t>(subMesh.indicesOffset) + subMesh.indicesCount;
+
+                for (uint32_t meshlet = subMesh.meshletsOffset; meshlet < subMesh.meshletsOffset + subMesh.meshletsCount; meshlet++) {
+                    const graphics::Meshlet& data = mesh.meshlets[meshlet];
+
+                    if (data.indicesOffset < subMesh.indicesOffset || static_cast<size_t>(data.indicesOffset) + data.indicesCount > indicesEnd) {
+                        throw FilesystemException { FilesystemException::Type::InvalidFileType,
+                                                    "Invalid mesh file: meshlet is out of submesh bounds!" };
+                    }
+                }
+            }
+
+            if (hasSharedRanges(vertexRanges)) {
+                throw FilesystemException { FilesystemException::Type::InvalidFileType, "Invalid mesh file: submeshes are sharing vertices!" };
+            }
+
+            if (hasSharedRanges(indexRanges)) {
+                throw FilesystemException { FilesystemException::Type::InvalidFileType, "Invalid mesh file: submeshes are sharing indices!" };
+            }
+        }
+
+        // FIFO cache, which is how ACMR is traditionally measured
+        class VertexCacheSimulator {
+        public:
+            VertexCacheSimulator(uint32_t amountOfVertices, uint32_t cacheSize)
+                : timestamps_(amountOfVertices, 0U)
+                , cacheSize_ { cacheSize }
+                , timestamp_ { cacheSize + 1U }
+            {}
+
+            // Returns true if vertex must be transformed
+            inline bool access(uint32_t vertex) noexcept
+            {
+                if (vertex >= timestamps_.size()) {
+                    return true;
+                }
+
+                if (timestamp_ - timestamps_[vertex] > cacheSize_) {
+                    timestamps_[vertex] = timestamp_++;
+                    return true;
+                }
+
+                return false;
+            }
+
+        private:
+            std::vector<uint32_t> timestamps_;
+            uint32_t cacheSize_;
+            uint32_t timestamp_;
+        };
+
+        VertexTriangles buildVertexTriangles(const uint32_t* indices, size_t amountOfTriangles, uint32_t amountOfVertices)
+        {
+            VertexTriangles result {};
+            result.offsets.resize(static_cast<size_t>(amountOfVertices) + 1, 0U);
+            result.triangles.resize(amountOfTriangles * 3);
+
+            for (size_t index = 0; index < amountOfTriangles * 3; index++) {
+                result.offsets[indices[index] + 1]++;
+            }
+
+            for (size_t vertex = 0; vertex < amountOfVertices; vertex++) {
+                result.offsets[vertex + 1] += result.offsets[vertex];
+            }
+
+            std::vector<uint32_t> writeOffsets { result.offsets.begin(), result.offsets.end() - 1 };
+
+            for (size_t index = 0; index < amountOfTriangles * 3; index++) {
+                result.triangles[writeOffsets[indices[index]]++] = static_cast<uint32_t>(index / 3);
+            }
+
+            return result;
+        }
+
+        graphics::Meshlet computeMeshletBounds(
+            const graphics::Vertex* vertices,
+            const uint32_t* indices,
+            const std::vector<uint32_t>& meshletVertices,
+            const std::vector<uint32_t>& meshletTriangles
+        )
+        {
+            graphics::Meshlet result {};
+
+            glm::vec3 min { std::numeric_limits<float>::max() };
+            glm::vec3 max { std::numeric_limits<float>::lowest() };
+
+            for (uint32_t vertex : meshletVertices) {
+                min = glm::min(min, vertices[vertex].position);
+                max = glm::max(max, vertices[vertex].position);
+            }
+
+            result.center = (min + max) * 0.5f;
+
+            for (uint32_t vertex : meshletVertices) {
+                result.radius = std::max(result.radius, glm::length(vertices[vertex].position - result.center));
+            }
+
+            // Normals are taken from geometry instead of vertex attributes, because culling is done by actual winding
+            std::vector<glm::vec3> normals {};
+            normals.reserve(meshletTriangles.size());
+
+            for (uint32_t triangle : meshletTriangles) {
+                const glm::vec3& first = vertices[indices[triangle * 3 + 0]].position;
+                const glm::vec3& second = vertices[indices[triangle * 3 + 1]].position;
+                const glm::vec3& third = vertices[indices[triangle * 3 + 2]].position;
+
+                glm::vec3 normal = glm::cross(second - first, third - first);
+                float length = glm::length(normal);
+
+                // Degenerate triangles are never rasterized, so they cannot widen the cone
+                if (length > 0.0f) {
+                    normals.push_back(normal / length);
+                }
+            }
+
+            glm::vec3 axis {};
+
+            for (const glm::vec3& normal : normals) {
+                axis += normal;
+            }
+
+            float axisLength = glm::length(axis);
+
+            if (normals.empty() || axisLength <= std::numeric_limits<float>::epsilon()) {
+                return result;
+            }
+
+            axis /= axisLength;
+            float minimalDot = 1.0f;
+
+            for (const glm::vec3& normal : normals) {
+                minimalDot = std::min(minimalDot, glm::dot(normal, axis));
+            }
+
+            // Spread of 90 degrees or more means that meshlet is visible from any direction
+            if (minimalDot <= 0.0f) {
+                return result;
+            }
+
+            result.coneAxis = axis;
+            result.coneCutoff = std::sqrt(1.0f - minimalDot * minimalDot);
+
+            return result;
+        }
+
+        // Greedy clustering, triangles that are adding least amount of new vertices are taken first
+        // This keeps meshlets connected and compact, which is what makes both sphere and cone tight
+        void buildSubMeshMeshlets(
+            const graphics::Vertex* vertices,
+            uint32_t* indices,
+            size_t amountOfTriangles,
+            uint32_t amountOfVertices,
+            uint32_t indicesOffset,
+            std::vector<graphics::Meshlet>& meshlets
+        )
+        {
+            VertexTriangles adjacency = buildVertexTriangles(indices, amountOfTriangles, amountOfVertices);
+            std::vector<uint32_t> vertexMeshlet(amountOfVertices, kInvalidIndex);
+            std::vector<bool> emittedTriangles(amountOfTriangles, false);
+
+            std::vector<uint32_t> reorderedIndices {};
+            std::vector<uint32_t> meshletVertices {};
+            std::vector<uint32_t> meshletTriangles {};
+            reorderedIndices.reserve(amountOfTriangles * 3);
+            meshletVertices.reserve(MeshOptimizer::kMaxMeshletVertices);
+            meshletTriangles.reserve(MeshOptimizer::kMaxMeshletTriangles);
+
+            size_t nextSeed = 0;
+            uint32_t currentMeshlet = 0;
+
+            auto finishMeshlet = [&]() {
+                graphics::Meshlet meshlet = computeMeshletBounds(vertices, indices, meshletVertices, meshletTriangles);
+                meshlet.indicesOffset = indicesOffset + static_cast<uint32_t>(reorderedIndices.size());
+                meshlet.indicesCount = static_cast<uint32_t>(meshletTriangles.size() * 3);
+                meshlets.push_back(meshlet);
+
+                for (uint32_t triangle : meshletTriangles) {
+                    reorderedIndices.insert(reorderedIndices.end(), indices + triangle * 3, indices + triangle * 3 + 3);
+                }
+
+                meshletVertices.clear();
+                meshletTriangles.clear();
+                currentMeshlet++;
+            };
+
+            auto newVertices = [&](uint32_t triangle) {
+                uint32_t result = 0U;
+
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    result += vertexMeshlet[indices[triangle * 3 + corner]] != currentMeshlet ? 1U : 0U;
+                }
+
+                return result;
+            };
+
+            for (size_t emitted = 0; emitted < amountOfTriangles; emitted++) {
+                uint32_t bestTriangle = kInvalidIndex;
+                uint32_t bestScore = std::numeric_limits<uint32_t>::max();
+                bool hasNeighbours = false;
+
+                for (uint32_t vertex : meshletVertices) {
+                    for (uint32_t offset = adjacency.offsets[vertex]; offset < adjacency.offsets[vertex + 1]; offset++) {
+                        uint32_t triangle = adjacency.triangles[offset];
+
+                        if (emittedTriangles[triangle]) {
+                            continue;
+                        }
+
+                        hasNeighbours = true;
+                        uint32_t score = newVertices(triangle);
+
+                        if (score < bestScore && meshletVertices.size() + score <= MeshOptimizer::kMaxMeshletVertices) {
+                            bestTriangle = triangle;
+                            bestScore = score;
+                        }
+                    }
+                }
+
+                // Meshlet is closed if it's either full or disconnected from the rest of geometry
+                // Small disconnected pieces (like foliage cards) are still merged, otherwise they would produce tiny meshlets
+                bool mustFinish = bestTriangle == kInvalidIndex &&
+                                  (hasNeighbours || meshletTriangles.size() >= MeshOptimizer::kMaxMeshletTriangles / 4);
+
+                if (mustFinish && !meshletTriangles.empty()) {
+                    finishMeshlet();
+                }
+
+                if (bestTriangle == kInvalidIndex) {
+                    while (emittedTriangles[nextSeed]) {
+                        nextSeed++;
+                    }
+
+                    bestTriangle = static_cast<uint32_t>(nextSeed);
+
+                    if (meshletVertices.size() + newVertices(bestTriangle) > MeshOptimizer::kMaxMeshletVertices) {
+                        finishMeshlet();
+                    }
+                }
+
+                emittedTriangles[bestTriangle] = true;
+                meshletTriangles.push_back(bestTriangle);
+
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    uint32_t vertex = indices[bestTriangle * 3 + corner];
+
+                    if (vertexMeshlet[vertex] != currentMeshlet) {
+                        vertexMeshlet[vertex] = currentMeshlet;
+                        meshletVertices.push_back(vertex);
+                    }
+                }
+
+                if (meshletTriangles.size() == MeshOptimizer::kMaxMeshletTriangles) {
+                    finishMeshlet();
+                }
+            }
+
+            if (!meshletTriangles.empty()) {
+                finishMeshlet();
+            }
+
+            std::copy(reorderedIndices.begin(), reorderedIndices.end(), indices);
+        }
+
+
+        // Scores are taken from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+        float computeVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+        {
+            constexpr float kCacheDecayPower = 1.5f;
+            constexpr float kLastTriangleScore = 0.75f;
+            constexpr float kValenceBoostScale = 2.0f;
+            constexpr float kValenceBoostPower = 0.5f;
+
+            // Vertex without remaining triangles must never affect choice of next triangle
+            if (remainingTriangles == 0) {
+                return -1.0f;
+            }
+
+            float score = 0.0f;
+
+            if (cachePosition >= 0) {
+                if (cachePosition < 3) {
+                    // Vertices of last triangle are getting fixed score, otherwise strips would be preferred over fans
+                    score = kLastTriangleScore;
+                }
+                else {
+                    constexpr float kScaler = 1.0f / static_cast<float>(MeshOptimizer::kVertexCacheSize - 3);
+                    score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * kScaler, kCacheDecayPower);
+                }
+            }
+
+            // Vertices with few remaining triangles are boosted, so they're finished instead of leaving lone triangles behind
+            return score + kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower);
+        }
+
+        void optimizeTriangleOrder(uint32_t* indices, size_t amountOfTriangles, uint32_t amountOfVertices)
+        {
+            VertexTriangles adjacency = buildVertexTriangles(indices, amountOfTriangles, amountOfVertices);
+            std::vector<uint32_t> remainingTriangles(amountOfVertices);
+            std::vector<int32_t> cachePositions(amountOfVertices, -1);
+            std::vector<float> vertexScores(amountOfVertices);
+            std::vector<float> triangleScores(amountOfTriangles);
+            std::vector<bool> emittedTriangles(amountOfTriangles, false);
+
+            for (uint32_t vertex = 0; vertex < amountOfVertices; vertex++) {
+                remainingTriangles[vertex] = adjacency.offsets[vertex + 1] - adjacency.offsets[vertex];
+                vertexScores[vertex] = computeVertexScore(-1, remainingTriangles[vertex]);
+            }
+
+            uint32_t bestTriangle = kInvalidIndex;
+            float bestScore = std::numeric_limits<float>::lowest();
+
+            for (size_t triangle = 0; triangle < amountOfTriangles; triangle++) {
+                const uint32_t* corners = indices + triangle * 3;
+                triangleScores[triangle] = vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+
+                if (triangleScores[triangle] > bestScore) {
+                    bestTriangle = static_cast<uint32_t>(triangle);
+                    bestScore = triangleScores[triangle];
+                }
+            }
+
+            std::vector<uint32_t> cache {};
+            std::vector<uint32_t> nextCache {};
+            std::vector<uint32_t> reorderedIndices {};
+            cache.reserve(MeshOptimizer::kVertexCacheSize + 3);
+            nextCache.reserve(MeshOptimizer::kVertexCacheSize + 3);
+            reorderedIndices.reserve(amountOfTriangles * 3);
+
+            size_t nextSeed = 0;
+
+            for (size_t emitted = 0; emitted < amountOfTriangles; emitted++) {
+                // Dead end, none of cached vertices has remaining triangles
+                if (bestTriangle == kInvalidIndex) {
+                    while (emittedTriangles[nextSeed]) {
+                        nextSeed++;
+                    }
+
+                    bestTriangle = static_cast<uint32_t>(nextSeed);
+                }
+
+                const uint32_t* corners = indices + static_cast<size_t>(bestTriangle) * 3;
+                reorderedIndices.insert(reorderedIndices.end(), corners, corners + 3);
+                emittedTriangles[bestTriangle] = true;
+                nextCache.clear();
+
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    uint32_t vertex = corners[corner];
+                    uint32_t* liveBegin = adjacency.triangles.data() + adjacency.offsets[vertex];
+                    uint32_t* liveEnd = liveBegin + remainingTriangles[vertex];
+
+                    // Order of remaining triangles doesn't matter, so removal is just swap with last one
+                    *std::find(liveBegin, liveEnd, bestTriangle) = *(liveEnd - 1);
+                    remainingTriangles[vertex]--;
+
+                    if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end()) {
+                        nextCache.push_back(vertex);
+                    }
+                }
+
+                // Degenerate triangles are adding less than three vertices
+                const size_t triangleVertices = nextCache.size();
+
+                for (uint32_t vertex : cache) {
+                    if (std::find(nextCache.begin(), nextCache.begin() + triangleVertices, vertex) == nextCache.begin() + triangleVertices) {
+                        nextCache.push_back(vertex);
+                    }
+                }
+
+                // Vertices that were pushed out of cache are updated as well, because their score drops to zero
+                for (size_t position = 0; position < nextCache.size(); position++) {
+                    uint32_t vertex = nextCache[position];
+                    cachePositions[vertex] = position < MeshOptimizer::kVertexCacheSize ? static_cast<int32_t>(position) : -1;
+                    vertexScores[vertex] = computeVertexScore(cachePositions[vertex], remainingTriangles[vertex]);
+                }
+
+                bestTriangle = kInvalidIndex;
+                bestScore = std::numeric_limits<float>::lowest();
+
+                for (uint32_t vertex : nextCache) {
+                    for (uint32_t offset = 0; offset < remainingTriangles[vertex]; offset++) {
+                        uint32_t triangle = adjacency.triangles[adjacency.offsets[vertex] + offset];
+                        const uint32_t* triangleCorners = indices + static_cast<size_t>(triangle) * 3;
+                        triangleScores[triangle] =
+                            vertexScores[triangleCorners[0]] + vertexScores[triangleCorners[1]] + vertexScores[triangleCorners[2]];
+
+                        if (triangleScores[triangle] > bestScore) {
+                            bestTriangle = triangle;
+                            bestScore = triangleScores[triangle];
+                        }
+                    }
+                }
+
+                nextCache.resize(std::min<size_t>(nextCache.size(), MeshOptimizer::kVertexCacheSize));
+                std::swap(cache, nextCache);
+            }
+
+            std::copy(reorderedIndices.begin(), reorderedIndices.end(), indices);
+        }
+
+        // Ranges are usually touching only small part of submesh vertices, so they're compacted before ordering
+        // Provided remap must be sized to amount of submesh vertices and filled with kInvalidIndex, it's restored on return
+        void optimizeRangeVertexCache(uint32_t* indices, size_t amountOfTriangles, std::vector<uint32_t>& remap)
+        {
+            std::vector<uint32_t> usedVertices {};
+            std::vector<uint32_t> localIndices {};
+            localIndices.resize(amountOfTriangles * 3);
+
+            for (size_t index = 0; index < amountOfTriangles * 3; index++) {
+                uint32_t vertex = indices[index];
+
+                if (remap[vertex] == kInvalidIndex) {
+                    remap[vertex] = static_cast<uint32_t>(usedVertices.size());
+                    usedVertices.push_back(vertex);
+                }
+
+                localIndices[index] = remap[vertex];
+            }
+
+            optimizeTriangleOrder(localIndices.data(), amountOfTriangles, static_cast<uint32_t>(usedVertices.size()));
+
+            for (size_t index = 0; index < amountOfTriangles * 3; index++) {
+                indices[index] = usedVertices[localIndices[index]];
+            }
+
+            for (uint32_t vertex : usedVertices) {
+                remap[vertex] = kInvalidIndex;
+            }
+        }
+
+        struct TriangleCluster {
+            uint32_t firstTriangle = 0U;
+            uint32_t amountOfTriangles = 0U;
+            float sortKey = 0.0f;
+        };
+
+        // Cluster begins at triangle that misses cache with every vertex, so reordering clusters mostly keeps cache efficiency
+        // It's only approximate, later triangles of cluster might still hit vertices left in cache by previous cluster in original order,
+        // so ACMR might slightly increase after reordering
+        std::vector<TriangleCluster> splitHardBoundaries(const uint32_t* indices, size_t amountOfTriangles, uint32_t amountOfVertices)
+        {
+            std::vector<TriangleCluster> result {};
+            VertexCacheSimulator cache { amountOfVertices, MeshOptimizer::kVertexCacheSize };
+
+            for (size_t triangle = 0; triangle < amountOfTriangles; triangle++) {
+                const uint32_t* corners = indices + triangle * 3;
+                uint32_t misses = 0U;
+
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    misses += cache.access(corners[corner]) ? 1U : 0U;
+                }
+
+                if (misses == 3 || result.empty()) {
+                    result.push_back({ static_cast<uint32_t>(triangle), 0U, 0.0f });
+                }
+
+                result.back().amountOfTriangles++;
+            }
+
+            return result;
+        }
+
+        // Based on "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" by Sander, Nehab and Barczak
+        // Clusters which are far from center of mesh in direction of their normal are most likely to occlude the rest
+        void computeClusterKeys(const graphics::Vertex* vertices, const uint32_t* indices, std::vector<TriangleCluster>& clusters)
+        {
+            std::vector<glm::vec3> centroids(clusters.size());
+            std::vector<glm::vec3> normals(clusters.size());
+            glm::vec3 meshCentroid {};
+            float meshArea = 0.0f;
+
+            for (size_t cluster = 0; cluster < clusters.size(); cluster++) {
+                float clusterArea = 0.0f;
+
+                for (uint32_t offset = 0; offset < clusters[cluster].amountOfTriangles; offset++) {
+                    const uint32_t* corners = indices + static_cast<size_t>(clusters[cluster].firstTriangle + offset) * 3;
+                    const glm::vec3& first = vertices[corners[0]].position;
+                    const glm::vec3& second = vertices[corners[1]].position;
+                    const glm::vec3& third = vertices[corners[2]].position;
+
+                    // Length of cross product is doubled area, so sum of them is already area weighted normal
+                    glm::vec3 normal = glm::cross(second - first, third - first);
+                    float area = glm::length(normal);
+
+                    centroids[cluster] += (first + second + third) * (area / 3.0f);
+                    normals[cluster] += normal;
+                    clusterArea += area;
+                }
+
+                meshCentroid += centroids[cluster];
+                meshArea += clusterArea;
+
+                if (clusterArea > 0.0f) {
+                    centroids[cluster] /= clusterArea;
+                }
+            }
+
+            if (meshArea > 0.0f) {
+                meshCentroid /= meshArea;
+            }
+
+            for (size_t cluster = 0; cluster < clusters.size(); cluster++) {
+                float normalLength = glm::length(normals[cluster]);
+
+                if (normalLength > 0.0f) {
+                    clusters[cluster].sortKey = glm::dot(centroids[cluster] - meshCentroid, normals[cluster] / normalLength);
+                }
+            }
+        }
+
+
+        // Symmetric matrix A, vector b and scalar c of error function p * A * p + 2 * b * p + c
+        struct Quadric {
+            float a00 = 0.0f;
+            float a11 = 0.0f;
+            float a22 = 0.0f;
+            float a01 = 0.0f;
+            float a02 = 0.0f;
+            float a12 = 0.0f;
+            float b0 = 0.0f;
+            float b1 = 0.0f;
+            float b2 = 0.0f;
+            float c = 0.0f;
+            float weight = 0.0f;
+
+            static Quadric fromPlane(const glm::vec3& normal, float distance, float weight) noexcept
+            {
+                Quadric result {};
+                result.a00 = normal.x * normal.x * weight;
+                result.a11 = normal.y * normal.y * weight;
+                result.a22 = normal.z * normal.z * weight;
+                result.a01 = normal.x * normal.y * weight;
+                result.a02 = normal.x * normal.z * weight;
+                result.a12 = normal.y * normal.z * weight;
+                result.b0 = normal.x * distance * weight;
+                result.b1 = normal.y * distance * weight;
+                result.b2 = normal.z * distance * weight;
+                result.c = distance * distance * weight;
+                result.weight = weight;
+
+                return result;
+            }
+
+            void add(const Quadric& other) noexcept
+            {
+                a00 += other.a00;
+                a11 += other.a11;
+                a22 += other.a22;
+                a01 += other.a01;
+                a02 += other.a02;
+                a12 += other.a12;
+                b0 += other.b0;
+                b1 += other.b1;
+                b2 += other.b2;
+                c += other.c;
+                weight += other.weight;
+            }
+
+            // Weighted mean of squared distances to every plane that was accumulated, so it's comparable with size of mesh
+            float error(const glm::vec3& point) const noexcept
+            {
+                if (weight <= 0.0f) {
+                    return 0.0f;
+                }
+
+                float x = a00 * point.x + a01 * point.y + a02 * point.z;
+                float y = a01 * point.x + a11 * point.y + a12 * point.z;
+                float z = a02 * point.x + a12 * point.y + a22 * point.z;
+                float result = x * point.x + y * point.y + z * point.z + 2.0f * (b0 * point.x + b1 * point.y + b2 * point.z) + c;
+
+                return std::fabs(result) / weight;
+            }
+        };
+
+        // Edge collapses towards existing vertices (half-edge collapses), so simplified indices are reusing same vertices
+        // Collapses are applied in passes, where each vertex might be touched only once, to keep adjacency valid during pass
+        class Simplifier {
+        public:
+            Simplifier(const graphics::Vertex* vertices, uint32_t amountOfVertices, const std::vector<uint32_t>& indices)
+                : positions_(amountOfVertices)
+                , quadrics_(amountOfVertices)
+                , lockedVertices_(amountOfVertices, false)
+            {
+                glm::vec3 min { std::numeric_limits<float>::max() };
+                glm::vec3 max { std::numeric_limits<float>::lowest() };
+
+                for (uint32_t vertex = 0; vertex < amountOfVertices; vertex++) {
+                    min = glm::min(min, vertices[vertex].position);
+                    max = glm::max(max, vertices[vertex].position);
+                }
+
+                // Positions are normalized, so errors are relative to size of submesh and floats stay precise
+                glm::vec3 extent = max - min;
+                float largestExtent = std::max(extent.x, std::max(extent.y, extent.z));
+                float scale = largestExtent > 0.0f ? 1.0f / largestExtent : 0.0f;
+
+                for (uint32_t vertex = 0; vertex < amountOfVertices; vertex++) {
+                    positions_[vertex] = (vertices[vertex].position - min) * scale;
+                }
+
+                for (size_t index = 0; index < indices.size(); index += 3) {
+                    const glm::vec3& first = positions_[indices[index + 0]];
+                    const glm::vec3& second = positions_[indices[index + 1]];
+                    const glm::vec3& third = positions_[indices[index + 2]];
+
+                    glm::vec3 normal = glm::cross(second - first, third - first);
+                    float area = glm::length(normal);
+
+                    if (area <= 0.0f) {
+                        continue;
+                    }
+
+                    normal /= area;
+                    Quadric quadric = Quadric::fromPlane(normal, -glm::dot(normal, first), area);
+
+                    for (size_t corner = 0; corner < 3; corner++) {
+                        quadrics_[indices[index + corner]].add(quadric);
+                    }
+                }
+
+                lockBorders(indices);
+                lockSeams();
+            }
+
+            // Returns false if nothing could be collapsed
+            bool simplify(std::vector<uint32_t>& indices, size_t targetIndices)
+            {
+                size_t initialSize = indices.size();
+
+                while (indices.size() > targetIndices) {
+                    if (!collapsePass(indices, targetIndices)) {
+                        break;
+                    }
+                }
+
+                return indices.size() < initialSize;
+            }
+
+            // Largest error of every collapse that was done so far, relative to largest extent of submesh
+            inline float error() const noexcept { return std::sqrt(error_); }
+
+        private:
+            // Cosine of largest allowed rotation of triangle normal during single collapse
+            static constexpr float kMaxNormalRotation = 0.25f;
+
+            struct Collapse {
+                uint32_t from = 0U;
+                uint32_t to = 0U;
+                float error = 0.0f;
+            };
+
+            // Moving border vertex changes silhouette of mesh and opens holes between neighbouring submeshes
+            void lockBorders(const std::vector<uint32_t>& indices)
+            {
+                std::vector<uint64_t> edges {};
+                edges.reserve(indices.size());
+
+                for (size_t index = 0; index < indices.size(); index += 3) {
+                    for (size_t corner = 0; corner < 3; corner++) {
+                        uint32_t first = indices[index + corner];
+                        uint32_t second = indices[index + (corner + 1) % 3];
+                        edges.push_back(packEdge(std::min(first, second), std::max(first, second)));
+                    }
+                }
+
+                std::sort(edges.begin(), edges.end());
+
+                for (size_t edge = 0; edge < edges.size();) {
+                    size_t next = edge + 1;
+
+                    while (next < edges.size() && edges[next] == edges[edge]) {
+                        next++;
+                    }
+
+                    if (next - edge == 1) {
+                        lockedVertices_[static_cast<uint32_t>(edges[edge] >> 32)] = true;
+                        lockedVertices_[static_cast<uint32_t>(edges[edge])] = true;
+                    }
+
+                    edge = next;
+                }
+            }
+
+            // Vertices with same position but different attributes are split by UV or normal seams
+            // They're topologically disconnected, so collapsing one side would open crack along seam
+            void lockSeams()
+            {
+                std::vector<uint32_t> order(positions_.size());
+                std::iota(order.begin(), order.end(), 0U);
+                std::sort(order.begin(), order.end(), [this](uint32_t first, uint32_t second) {
+                    const glm::vec3& a = positions_[first];
+                    const glm::vec3& b = positions_[second];
+                    return a.x != b.x ? a.x < b.x : (a.y != b.y ? a.y < b.y : a.z < b.z);
+                });
+
+                for (size_t index = 1; index < order.size(); index++) {
+                    if (positions_[order[index]] == positions_[order[index - 1]]) {
+                        lockedVertices_[order[index]] = true;
+                        lockedVertices_[order[index - 1]] = true;
+                    }
+                }
+            }
+
+            bool flipsTriangles(const std::vector<uint32_t>& indices, const VertexTriangles& adjacency, uint32_t from, uint32_t to) const
+            {
+                for (uint32_t offset = adjacency.offsets[from]; offset < adjacency.offsets[from + 1]; offset++) {
+                    const uint32_t* corners = indices.data() + static_cast<size_t>(adjacency.triangles[offset]) * 3;
+
+                    // Triangles that are sharing collapsed edge are removed entirely
+                    if (corners[0] == to || corners[1] == to || corners[2] == to) {
+                        continue;
+                    }
+
+                    glm::vec3 before[3] = { positions_[corners[0]], positions_[corners[1]], positions_[corners[2]] };
+                    glm::vec3 after[3] = { before[0], before[1], before[2] };
+
+                    for (size_t corner = 0; corner < 3; corner++) {
+                        if (corners[corner] == from) {
+                            after[corner] = positions_[to];
+                        }
+                    }
+
+                    glm::vec3 normalBefore = glm::cross(before[1] - before[0], before[2] - before[0]);
+                    glm::vec3 normalAfter = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+                    // Large rotation of triangle usually means that it became fold, even if it's not flipped completely
+                    if (glm::dot(normalBefore, normalAfter) <= kMaxNormalRotation * glm::length(normalBefore) * glm::length(normalAfter)) {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            bool collapsePass(std::vector<uint32_t>& indices, size_t targetIndices)
+            {
+                const uint32_t amountOfVertices = static_cast<uint32_t>(positions_.size());
+                const size_t amountOfTriangles = indices.size() / 3;
+                VertexTriangles adjacency = buildVertexTriangles(indices.data(), amountOfTriangles, amountOfVertices);
+
+                std::vector<uint64_t> edges {};
+                edges.reserve(indices.size());
+
+                for (size_t index = 0; index < indices.size(); index += 3) {
+                    for (size_t corner = 0; corner < 3; corner++) {
+                        uint32_t first = indices[index + corner];
+                        uint32_t second = indices[index + (corner + 1) % 3];
+                        edges.push_back(packEdge(std::min(first, second), std::max(first, second)));
+                    }
+                }
+
+                std::sort(edges.begin(), edges.end());
+                edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+                std::vector<Collapse> collapses {};
+                collapses.reserve(edges.size());
+
+                for (uint64_t edge : edges) {
+                    uint32_t first = static_cast<uint32_t>(edge >> 32);
+                    uint32_t second = static_cast<uint32_t>(edge);
+
+                    // Combined quadric is evaluated at position of remaining vertex
+                    Quadric combined = quadrics_[first];
+                    combined.add(quadrics_[second]);
+
+                    float firstIntoSecond = combined.error(positions_[second]);
+                    float secondIntoFirst = combined.error(positions_[first]);
+
+                    if (!lockedVertices_[first] && (lockedVertices_[second] || firstIntoSecond <= secondIntoFirst)) {
+                        collapses.push_back({ first, second, firstIntoSecond });
+                    }
+                    else if (!lockedVertices_[second]) {
+                        collapses.push_back({ second, first, secondIntoFirst });
+                    }
+                }
+
+                std::sort(collapses.begin(), collapses.end(), [](const Collapse& first, const Collapse& second) {
+                    return first.error < second.error;
+                });
+
+                std::vector<uint32_t> remap(amountOfVertices);
+                std::vector<bool> touchedVertices(amountOfVertices, false);
+                std::iota(remap.begin(), remap.end(), 0U);
+
+                const size_t indicesToRemove = indices.size() - targetIndices;
+                size_t removedIndices = 0;
+                bool hasCollapsed = false;
+
+                for (const Collapse& collapse : collapses) {
+                    if (touchedVertices[collapse.from] || touchedVertices[collapse.to]) {
+                        continue;
+                    }
+
+                    if (flipsTriangles(indices, adjacency, collapse.from, collapse.to)) {
+                        continue;
+                    }
+
+                    remap[collapse.from] = collapse.to;
+                    quadrics_[collapse.to].add(quadrics_[collapse.from]);
+                    error_ = std::max(error_, collapse.error);
+                    hasCollapsed = true;
+
+                    // Whole neighbourhood is changed by this collapse, so it cannot be validated against stale adjacency anymore
+                    for (uint32_t offset = adjacency.offsets[collapse.from]; offset < adjacency.offsets[collapse.from + 1]; offset++) {
+                        const uint32_t* corners = indices.data() + static_cast<size_t>(adjacency.triangles[offset]) * 3;
+                        bool isRemoved = corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to;
+
+                        for (size_t corner = 0; corner < 3; corner++) {
+                            touchedVertices[corners[corner]] = true;
+                        }
+
+                        removedIndices += isRemoved ? 3 : 0;
+                    }
+
+                    if (removedIndices >= indicesToRemove) {
+                        break;
+                    }
+                }
+
+                if (!hasCollapsed) {
+                    return false;
+                }
+
+                size_t writeOffset = 0;
+
+                for (size_t index = 0; index < indices.size(); index += 3) {
+                    uint32_t first = remap[indices[index + 0]];
+                    uint32_t second = remap[indices[index + 1]];
+                    uint32_t third = remap[indices[index + 2]];
+
+                    if (first == second || first == third || second == third) {
+                        continue;
+                    }
+
+                    indices[writeOffset++] = first;
+                    indices[writeOffset++] = second;
+                    indices[writeOffset++] = third;
+                }
+
+                indices.resize(writeOffset);
+
+                return true;
+            }
+
+            static inline uint64_t packEdge(uint32_t first, uint32_t second) noexcept
+            {
+                return (static_cast<uint64_t>(first) << 32) | second;
+            }
+
+            std::vector<glm::vec3> positions_;
+            std::vector<Quadric> quadrics_;
+            std::vector<bool> lockedVertices_;
+            float error_ = 0.0f;
+        };
+
+    } // namespace detail
+
+    void MeshOptimizer::buildMeshlets(MeshData& mesh)
+    {
+        detail::validateSubMeshes(mesh);
+
+        std::vector<std::vector<graphics::Meshlet>> subMeshesMeshlets {};
+        subMeshesMeshlets.resize(mesh.subMeshes.size());
+
+        // Submeshes are owning disjoint ranges of indices, so they can be processed independently
+        tbb::parallel_for(size_t { 0 }, mesh.subMeshes.size(), [&](size_t index) {
+            const MeshData::SubMesh& subMesh = mesh.subMeshes[index];
+
+            detail::buildSubMeshMeshlets(
+                mesh.vertices.data() + subMesh.verticesOffset,
+                mesh.indices.data() + subMesh.indicesOffset,
+                subMesh.indicesCount / 3,
+                subMesh.verticesCount,
+                subMesh.indicesOffset,
+                subMeshesMeshlets[index]
+            );
+        });
+
+        mesh.meshlets.clear();
+
+        for (size_t index = 0; index < mesh.subMeshes.size(); index++) {
+            MeshData::SubMesh& subMesh = mesh.subMeshes[index];
+            subMesh.meshletsOffset = static_cast<uint32_t>(mesh.meshlets.size());
+            subMesh.meshletsCount = static_cast<uint32_t>(subMeshesMeshlets[index].size());
+
+            mesh.meshlets.insert(mesh.meshlets.end(), subMeshesMeshlets[index].begin(), subMeshesMeshlets[index].end());
+        }
+    }
+
+    float MeshOptimizer::computeAcmr(const MeshData& mesh, uint32_t cacheSize)
+    {
+        size_t amountOfTriangles = 0ULL;
+        size_t amountOfMisses = 0ULL;
+
+        for (const auto& subMesh : mesh.subMeshes) {
+            if (static_cast<size_t>(subMesh.indicesOffset) + subMesh.indicesCount > mesh.indices.size()) {
+                continue;
+            }
+
+            // Each submesh is separate draw call, so it always begins with empty cache
+            detail::VertexCacheSimulator cache { subMesh.verticesCount, cacheSize };
+            const uint32_t* indices = mesh.indices.data() + subMesh.indicesOffset;
+
+            for (uint32_t index = 0; index < subMesh.indicesCount; index++) {
+                amountOfMisses += cache.access(indices[index]) ? 1ULL : 0ULL;
+            }
+
+            amountOfTriangles += subMesh.indicesCount / 3;
+        }
+
+        return amountOfTriangles == 0 ? 0.0f : static_cast<float>(amountOfMisses) / static_cast<float>(amountOfTriangles);
+    }
+
+    void MeshOptimizer::optimizeVertexCache(MeshData& mesh)
+    {
+        detail::validateSubMeshes(mesh);
+
+        tbb::parallel_for(size_t { 0 }, mesh.subMeshes.size(), [&](size_t subMeshIndex) {
+            const MeshData::SubMesh& subMesh = mesh.subMeshes[subMeshIndex];
+            std::vector<uint32_t> remap(subMesh.verticesCount, detail::kInvalidIndex);
+
+            if (subMesh.meshletsCount == 0) {
+                detail::optimizeRangeVertexCache(mesh.indices.data() + subMesh.indicesOffset, subMesh.indicesCount / 3, remap);
+            }
+
+            for (uint32_t meshlet = subMesh.meshletsOffset; meshlet < subMesh.meshletsOffset + subMesh.meshletsCount; meshlet++) {
+                const graphics::Meshlet& data = mesh.meshlets[meshlet];
+                detail::optimizeRangeVertexCache(mesh.indices.data() + data.indicesOffset, data.indicesCount / 3, remap);
+            }
+
+            for (const auto& lod : subMesh.lods) {
+                detail::optimizeRangeVertexCache(mesh.indices.data() + lod.indicesOffset, lod.indicesCount / 3, remap);
+            }
+        });
+    }
+
+    void MeshOptimizer::optimizeOverdraw(MeshData& mesh)
+    {
+        detail::validateSubMeshes(mesh);
+
+        tbb::parallel_for(size_t { 0 }, mesh.subMeshes.size(), [&](size_t subMeshIndex) {
+            const MeshData::SubMesh& subMesh = mesh.subMeshes[subMeshIndex];
+            uint32_t* indices = mesh.indices.data() + subMesh.indicesOffset;
+            std::vector<detail::TriangleCluster> clusters {};
+
+            if (subMesh.meshletsCount == 0) {
+                clusters = detail::splitHardBoundaries(indices, subMesh.indicesCount / 3, subMesh.verticesCount);
+            }
+            else {
+                for (uint32_t meshlet = subMesh.meshletsOffset; meshlet < subMesh.meshletsOffset + subMesh.meshletsCount; meshlet++) {
+                    const graphics::Meshlet& data = mesh.meshlets[meshlet];
+                    clusters.push_back({ (data.indicesOffset - subMesh.indicesOffset) / 3, data.indicesCount / 3, 0.0f });
+                }
+            }
+
+            if (clusters.size() < 2) {
+                return;
+            }
+
+            detail::computeClusterKeys(mesh.vertices.data() + subMesh.verticesOffset, indices, clusters);
+
+            std::vector<uint32_t> order(clusters.size());
+            std::iota(order.begin(), order.end(), 0U);
+            std::stable_sort(order.begin(), order.end(), [&clusters](uint32_t first, uint32_t second) {
+                return clusters[first].sortKey > clusters[second].sortKey;
+            });
+
+            std::vector<uint32_t> reorderedIndices {};
+            std::vector<graphics::Meshlet> reorderedMeshlets {};
+            reorderedIndices.reserve(subMesh.indicesCount);
+            reorderedMeshlets.reserve(subMesh.meshletsCount);
+
+            for (uint32_t cluster : order) {
+                const uint32_t* begin = indices + static_cast<size_t>(clusters[cluster].firstTriangle) * 3;
+
+                // Meshlets are moved together with their triangles
+                if (subMesh.meshletsCount != 0) {
+                    graphics::Meshlet meshlet = mesh.meshlets[subMesh.meshletsOffset + cluster];
+                    meshlet.indicesOffset = subMesh.indicesOffset + static_cast<uint32_t>(reorderedIndices.size());
+                    reorderedMeshlets.push_back(meshlet);
+                }
+
+                reorderedIndices.insert(reorderedIndices.end(), begin, begin + static_cast<size_t>(clusters[cluster].amountOfTriangles) * 3);
+            }
+
+            std::copy(reorderedIndices.begin(), reorderedIndices.end(), indices);
+            std::copy(reorderedMeshlets.begin(), reorderedMeshlets.end(), mesh.meshlets.begin() + subMesh.meshletsOffset);
+        });
+    }
+
+    void MeshOptimizer::optimizeVertexFetch(MeshData& mesh)
+    {
+        detail::validateSubMeshes(mesh);
+
+        tbb::parallel_for(size_t { 0 }, mesh.subMeshes.size(), [&](size_t subMeshIndex) {
+            const MeshData::SubMesh& subMesh = mesh.subMeshes[subMeshIndex];
+            uint32_t* indices = mesh.indices.data() + subMesh.indicesOffset;
+            graphics::Vertex* vertices = mesh.vertices.data() + subMesh.verticesOffset;
+
+            std::vector<uint32_t> remap(subMesh.verticesCount, detail::kInvalidIndex);
+            uint32_t nextVertex = 0U;
+
+            for (uint32_t index = 0; index < subMesh.indicesCount; index++) {
+                if (remap[indices[index]] == detail::kInvalidIndex) {
+                    remap[indices[index]] = nextVertex++;
+                }
+
+                indices[index] = remap[indices[index]];
+            }
+
+            // Unreferenced vertices are kept at the end, so submesh ranges stay exactly the same
+            for (uint32_t& target : remap) {
+                if (target == detail::kInvalidIndex) {
+                    target = nextVertex++;
+                }
+            }
+
+            // LODs are using subset of same vertices, so their order is decided by most detailed version
+            for (const auto& lod : subMesh.lods) {
+                uint32_t* lodIndices = mesh.indices.data() + lod.indicesOffset;
+
+                for (uint32_t index = 0; index < lod.indicesCount; index++) {
+                    lodIndices[index] = remap[lodIndices[index]];
+                }
+            }
+
+            std::vector<graphics::Vertex> reorderedVertices(subMesh.verticesCount);
+
+            for (uint32_t vertex = 0; vertex < subMesh.verticesCount; vertex++) {
+                reorderedVertices[remap[vertex]] = vertices[vertex];
+            }
+
+            std::copy(reorderedVertices.begin(), reorderedVertices.end(), vertices);
+        });
+    }
+
+    void MeshOptimizer::generateLods(MeshData& mesh, uint32_t amountOfLods)
+    {
+        detail::validateSubMeshes(mesh);
+
+        // Indices of LODs are always stored after indices of every submesh, so previous LODs are simply dropped
+        size_t subMeshesIndices = 0ULL;
+
+        for (auto& subMesh : mesh.subMeshes) {
+            subMeshesIndices = std::max(subMeshesIndices, static_cast<size_t>(subMesh.indicesOffset) + subMesh.indicesCount);
+            subMesh.lods.clear();
+        }
+
+        mesh.indices.resize(subMeshesIndices);
+
+        std::vector<std::vector<uint32_t>> subMeshesIndicesOfLods {};
+        subMeshesIndicesOfLods.resize(mesh.subMeshes.size());
+
+        tbb::parallel_for(size_t { 0 }, mesh.subMeshes.size(), [&](size_t subMeshIndex) {
+            MeshData::SubMesh& subMesh = mesh.subMeshes[subMeshIndex];
+            std::vector<uint32_t>& lodIndices = subMeshesIndicesOfLods[subMeshIndex];
+
+            const uint32_t* begin = mesh.indices.data() + subMesh.indicesOffset;
+            std::vector<uint32_t> currentIndices { begin, begin + subMesh.indicesCount / 3 * 3 };
+
+            if (currentIndices.empty()) {
+                return;
+            }
+
+            // Each LOD is simplified from previous one, quadrics are kept, so errors are still measured against original surface
+            detail::Simplifier simplifier { mesh.vertices.data() + subMesh.verticesOffset, subMesh.verticesCount, currentIndices };
+
+            for (uint32_t level = 0; level < amountOfLods; level++) {
+                size_t previousSize = currentIndices.size();
+                size_t targetIndices = static_cast<size_t>(static_cast<float>(previousSize / 3) * kLodReduction) * 3;
+
+                if (targetIndices == 0 || !simplifier.simplify(currentIndices, targetIndices)) {
+                    break;
+                }
+
+                // LOD that is barely smaller than previous one isn't worth of memory it takes
+                if (static_cast<float>(currentIndices.size()) > static_cast<float>(previousSize) * (1.0f + kLodReduction) * 0.5f) {
+                    break;
+                }
+
+                graphics::SubMeshLod lod {};
+                lod.indicesOffset = static_cast<uint32_t>(lodIndices.size());
+                lod.indicesCount = static_cast<uint32_t>(currentIndices.size());
+                lod.error = simplifier.error();
+                subMesh.lods.push_back(lod);
+
+                lodIndices.insert(lodIndices.end(), currentIndices.begin(), currentIndices.end());
+            }
+        });
+
+        for (size_t index = 0; index < mesh.subMeshes.size(); index++) {
+            uint32_t lodsOffset = static_cast<uint32_t>(mesh.indices.size());
+
+            for (auto& lod : mesh.subMeshes[index].lods) {
+                lod.indicesOffset += lodsOffset;
+            }
+
+            mesh.indices.insert(mesh.indices.end(), subMeshesIndicesOfLods[index].begin(), subMeshesIndicesOfLods[index].end());
+        }
+    }
+
+} // namespace coffee
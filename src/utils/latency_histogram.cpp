@@ -0,0 +1,93 @@
+#include <coffee/utils/latency_histogram.hpp>
+
+#include <coffee/utils/math.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace coffee {
+
+    void LatencyHistogram::record(std::chrono::steady_clock::duration duration) noexcept
+    {
+        uint64_t microseconds = static_cast<uint64_t>(std::max<int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count(), 0));
+        uint32_t clampedMicroseconds = static_cast<uint32_t>(std::min<uint64_t>(microseconds, std::numeric_limits<uint32_t>::max()));
+
+        buckets_[bucketIndex(clampedMicroseconds)].fetch_add(1ULL, std::memory_order_relaxed);
+        totalMicroseconds_.fetch_add(microseconds, std::memory_order_relaxed);
+
+        uint64_t currentMax = maxMicroseconds_.load(std::memory_order_relaxed);
+        while (currentMax < microseconds && !maxMicroseconds_.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed)) {}
+    }
+
+    LatencyHistogram::Summary LatencyHistogram::summary() const noexcept
+    {
+        std::array<uint64_t, kAmountOfBuckets> counts {};
+        uint64_t samples = 0ULL;
+
+        // Samples are counted from buckets themselves, so percentiles always match with what was actually read
+        for (uint32_t index = 0; index < kAmountOfBuckets; index++) {
+            counts[index] = buckets_[index].load(std::memory_order_relaxed);
+            samples += counts[index];
+        }
+
+        Summary result {};
+        result.samples = samples;
+        result.totalMicroseconds = totalMicroseconds_.load(std::memory_order_relaxed);
+        result.maxMicroseconds = maxMicroseconds_.load(std::memory_order_relaxed);
+
+        if (samples == 0) {
+            return result;
+        }
+
+        // Ranks are rounded up, so single sample is reported as both p50 and p99
+        const uint64_t p50Rank = (samples * 50ULL + 99ULL) / 100ULL;
+        const uint64_t p99Rank = (samples * 99ULL + 99ULL) / 100ULL;
+        uint64_t accumulated = 0ULL;
+
+        for (uint32_t index = 0; index < kAmountOfBuckets; index++) {
+            if (counts[index] == 0) {
+                continue;
+            }
+
+            uint64_t previous = accumulated;
+            accumulated += counts[index];
+
+            if (previous < p50Rank && accumulated >= p50Rank) {
+                result.p50Microseconds = std::min(bucketUpperBound(index), result.maxMicroseconds);
+            }
+
+            if (previous < p99Rank && accumulated >= p99Rank) {
+                result.p99Microseconds = std::min(bucketUpperBound(index), result.maxMicroseconds);
+                break;
+            }
+        }
+
+        return result;
+    }
+
+    uint32_t LatencyHistogram::bucketIndex(uint32_t microseconds) noexcept
+    {
+        if (microseconds < kSubBuckets) {
+            return microseconds;
+        }
+
+        // Top two bits after highest one selects sub-bucket inside of power of two
+        uint32_t highestBit = Math::indexOfHighestBit(microseconds);
+        uint32_t subBucket = (microseconds >> (highestBit - 2U)) & (kSubBuckets - 1U);
+
+        return kSubBuckets + (highestBit - 2U) * kSubBuckets + subBucket;
+    }
+
+    uint64_t LatencyHistogram::bucketUpperBound(uint32_t index) noexcept
+    {
+        if (index < kSubBuckets) {
+            return index;
+        }
+
+        uint32_t shift = (index - kSubBuckets) / kSubBuckets;
+        uint64_t subBucket = (index - kSubBuckets) % kSubBuckets;
+
+        return ((kSubBuckets + subBucket + 1ULL) << shift) - 1ULL;
+    }
+
+} // namespace coffee
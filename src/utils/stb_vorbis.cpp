@@ -0,0 +1,2 @@
+// stb_vorbis defines short single-letter macros inside of implementation, so it's compiled in separate translation unit
+#include <stb_vorbis/stb_vorbis.c>
@@ -0,0 +1,3 @@
+// ZSTD embeds it's own namespaced copy of XXH64, which conflicts with XXH3 that is included everywhere else
+// So full library (both compression and decompression) is compiled in separate translation unit
+#include <zstd/zstd.c>